@@ -0,0 +1,64 @@
+#include "arena.h"
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+Arena::Arena(size_t chunkSize) {
+    _chunkSize = max(chunkSize, (size_t) 4096);
+    _chunk = NULL;
+    _cursor = NULL;
+    _end = NULL;
+    _allocated = 0;
+}
+
+Arena::~Arena() {
+    release();
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment) {
+    lock_guard<mutex> lock(_mutex);
+
+    uintptr_t aligned = ((uintptr_t) _cursor + alignment - 1) & ~(uintptr_t) (alignment - 1);
+
+    if(_cursor == NULL || aligned + bytes > (uintptr_t) _end) {
+        //Open a new chunk, big enough for oversized requests
+        size_t size = max(_chunkSize, bytes + alignment + sizeof(Chunk));
+        Chunk* chunk = static_cast<Chunk*>(malloc(size));
+        if(chunk == NULL)
+            throw bad_alloc();
+
+        chunk->previous = _chunk;
+        chunk->size = size;
+        _chunk = chunk;
+        _cursor = reinterpret_cast<char*>(chunk + 1);
+        _end = reinterpret_cast<char*>(chunk) + size;
+
+        aligned = ((uintptr_t) _cursor + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    }
+
+    _cursor = reinterpret_cast<char*>(aligned + bytes);
+    _allocated += bytes;
+
+    return reinterpret_cast<void*>(aligned);
+}
+
+void Arena::release() {
+    lock_guard<mutex> lock(_mutex);
+
+    while(_chunk != NULL) {
+        Chunk* previous = _chunk->previous;
+        free(_chunk);
+        _chunk = previous;
+    }
+
+    _cursor = NULL;
+    _end = NULL;
+    _allocated = 0;
+}
+
+size_t Arena::getAllocatedBytes() const {
+    lock_guard<mutex> lock(_mutex);
+    return _allocated;
+}
@@ -0,0 +1,113 @@
+#ifndef __ARENA__H__
+#define __ARENA__H__
+
+#include <cstddef>
+#include <new>
+#include <mutex>
+#include <utility>
+#include <type_traits>
+
+/*
+ * A monotonic memory arena. Memory is handed out from big chunks by bumping a pointer and is never
+ * given back one by one: release() frees every chunk at once. Allocation is thread safe.
+ * Objects built on the arena (see make) may be abandoned without running their destructors when
+ * every container inside them also allocates from the arena, release() reclaims all of it.
+ */
+class Arena {
+
+public:
+    /*
+     * Construct an empty arena, that will request chunks of at least chunkSize bytes.
+     */
+    Arena(size_t chunkSize = 1 << 20);
+    ~Arena();
+
+    /*
+     * Get bytes of memory aligned to alignment, that stays valid until the next release().
+     */
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    /*
+     * Free every chunk of the arena. Nothing allocated on it may be used afterwards.
+     */
+    void release();
+
+    /*
+     * Get the count of bytes handed out since the last release().
+     */
+    size_t getAllocatedBytes() const;
+
+    /*
+     * Construct an object of type T on the arena.
+     */
+    template<class T, class... Args>
+    T* make(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+private:
+    struct Chunk {
+        Chunk* previous;
+        size_t size;
+    };
+
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    size_t _chunkSize;
+    Chunk* _chunk;
+    char* _cursor;
+    char* _end;
+    size_t _allocated;
+    mutable std::mutex _mutex;
+};
+
+/*
+ * A standard allocator drawing memory from an Arena. Deallocation is a no-op on the arena.
+ * A default constructed ArenaAllocator (NULL arena) uses the global operator new and delete.
+ */
+template<class T>
+class ArenaAllocator {
+
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    ArenaAllocator(Arena* arena = NULL) : _arena(arena) { }
+
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : _arena(other.getArena()) { }
+
+    T* allocate(size_t n) {
+        if(_arena != NULL)
+            return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+        if(_arena == NULL)
+            ::operator delete(p);
+    }
+
+    Arena* getArena() const {
+        return _arena;
+    }
+
+private:
+    Arena* _arena;
+};
+
+template<class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() == b.getArena();
+}
+
+template<class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() != b.getArena();
+}
+
+#endif
@@ -0,0 +1,190 @@
+#include "compressed.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+CompressedGraph::CompressedGraph(const Graph& g, bool quantizeWeights) {
+    uint n = g.getNodesCount();
+    _oriented = g.isOrientedGraph();
+    _offsets = vector<uint64_t>(n + 1, 0);
+    _firstEdge = vector<uint>(n + 1, 0);
+
+    vector<float> weights;
+    vector<pair<uint,float> > neighbors;
+    uint selfLoops = 0;
+
+    for (uint v = 0; v < n; ++v) {
+        neighbors.clear();
+        for(auto it = g.adjacentsOf(v); it.thereIsMore(); it.advance())
+            neighbors.push_back(it.next());
+
+        //Sort the neighbors, keeping the first weight seen for repeated edges
+        stable_sort(neighbors.begin(), neighbors.end(),
+                    [](const pair<uint,float>& a, const pair<uint,float>& b) { return a.first < b.first; });
+        neighbors.erase(unique(neighbors.begin(), neighbors.end(),
+                               [](const pair<uint,float>& a, const pair<uint,float>& b) { return a.first == b.first; }),
+                        neighbors.end());
+
+        _offsets[v] = _stream.size();
+        _firstEdge[v] = weights.size();
+
+        for (uint i = 0; i < neighbors.size(); ++i) {
+            _writeVarint(_stream, i == 0 ? neighbors[i].first : neighbors[i].first - neighbors[i-1].first - 1);
+            weights.push_back(neighbors[i].second);
+            selfLoops += neighbors[i].first == v;
+        }
+    }
+
+    _offsets[n] = _stream.size();
+    _firstEdge[n] = weights.size();
+    _stream.shrink_to_fit();
+
+    //A non-oriented edge is stored from both ends, but a self loop only once
+    _edgesCount = _oriented ? weights.size() : (weights.size() + selfLoops) / 2;
+
+    float maxWeight = 0;
+    _minWeight = weights.empty() ? 1 : weights[0];
+    _step = 0;
+    if(!weights.empty()) {
+        _minWeight = *min_element(weights.begin(), weights.end());
+        maxWeight = *max_element(weights.begin(), weights.end());
+    }
+
+    if(weights.empty() || _minWeight == maxWeight) {
+        _weightsMode = UNIFORM_WEIGHTS;
+
+    } else if(quantizeWeights) {
+        _weightsMode = QUANTIZED_WEIGHTS;
+        _step = (maxWeight - _minWeight) / 65535;
+        _quantized = vector<uint16_t>(weights.size());
+        for (uint i = 0; i < weights.size(); ++i)
+            _quantized[i] = (uint16_t) lround((weights[i] - _minWeight) / _step);
+
+    } else {
+        _weightsMode = FULL_WEIGHTS;
+        _weights.swap(weights);
+    }
+}
+
+bool CompressedGraph::isOrientedGraph() const {
+    return _oriented;
+}
+
+uint CompressedGraph::getNodesCount() const {
+    return _firstEdge.size() - 1;
+}
+
+uint CompressedGraph::getEdgesCount() const {
+    return _edgesCount;
+}
+
+uint CompressedGraph::getDegree(uint v) const {
+    if(v >= getNodesCount())
+        throw invalid_argument("Invalid argument on getDegree member function, v isn't a node of the graph.");
+
+    return _firstEdge[v+1] - _firstEdge[v];
+}
+
+bool CompressedGraph::areAdjacent(uint v1, uint v2) const {
+    if(v1 >= getNodesCount() || v2 >= getNodesCount())
+        throw invalid_argument("Invalid arguments on areAdjacent member function, v1 or v2 aren't nodes of the graph.");
+
+    return getEdgeWeight(v1, v2) != DEFAULT_WEIGHT;
+}
+
+float CompressedGraph::getEdgeWeight(uint v1, uint v2) const {
+    if(v1 >= getNodesCount() || v2 >= getNodesCount())
+        throw invalid_argument("Invalid arguments on getEdgeWeight member function, v1 or v2 aren't nodes of the graph.");
+
+    const unsigned char* cursor = _stream.data() + _offsets[v1];
+    uint neighbor = 0;
+
+    for (uint edge = _firstEdge[v1]; edge < _firstEdge[v1+1]; ++edge) {
+        neighbor += _readVarint(cursor) + (edge == _firstEdge[v1] ? 0 : 1);
+
+        if(neighbor == v2)
+            return _weightOf(edge);
+        if(neighbor > v2)
+            break;
+    }
+
+    return DEFAULT_WEIGHT;
+}
+
+const CompressedGraph::AdjacentsIterator CompressedGraph::adjacentsOf(uint v) const {
+    if(v >= getNodesCount())
+        throw invalid_argument("Invalid argument on adjacentsOf member function, v is not a node of the graph.");
+
+    return AdjacentsIterator(this, v);
+}
+
+size_t CompressedGraph::getMemoryUsage() const {
+    return sizeof(CompressedGraph)
+         + _offsets.capacity() * sizeof(uint64_t)
+         + _firstEdge.capacity() * sizeof(uint)
+         + _stream.capacity()
+         + _quantized.capacity() * sizeof(uint16_t)
+         + _weights.capacity() * sizeof(float);
+}
+
+float CompressedGraph::_weightOf(uint edge) const {
+    if(_weightsMode == UNIFORM_WEIGHTS)
+        return _minWeight;
+    else if(_weightsMode == QUANTIZED_WEIGHTS)
+        return _minWeight + _quantized[edge] * _step;
+    else
+        return _weights[edge];
+}
+
+void CompressedGraph::_writeVarint(vector<unsigned char>& out, uint value) {
+    while(value >= 0x80) {
+        out.push_back((unsigned char) (value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((unsigned char) value);
+}
+
+uint CompressedGraph::_readVarint(const unsigned char*& in) {
+    uint value = *in & 0x7f;
+    uint shift = 7;
+
+    while(*in++ & 0x80) {
+        value |= (uint) (*in & 0x7f) << shift;
+        shift += 7;
+    }
+
+    return value;
+}
+
+
+/*
+ * Adjacents iterator implementation.
+ */
+
+CompressedGraph::AdjacentsIterator::AdjacentsIterator(const CompressedGraph* g, uint v) {
+    _g = g;
+    _cursor = g->_stream.data() + g->_offsets[v];
+    _edge = g->_firstEdge[v];
+    _remaining = g->_firstEdge[v+1] - _edge;
+    _current = 0;
+
+    if(_remaining > 0)
+        _current = _readVarint(_cursor);
+}
+
+pair<uint,float> CompressedGraph::AdjacentsIterator::next() const {
+    return make_pair(_current, _g->_weightOf(_edge));
+}
+
+bool CompressedGraph::AdjacentsIterator::thereIsMore() const {
+    return _remaining > 0;
+}
+
+void CompressedGraph::AdjacentsIterator::advance() {
+    if(--_remaining > 0) {
+        _current += _readVarint(_cursor) + 1;
+        _edge++;
+    }
+}
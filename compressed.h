@@ -0,0 +1,119 @@
+#ifndef __COMPRESSED__H__
+#define __COMPRESSED__H__
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include "graph.h"
+#include "traversal.h"
+
+/*
+ * A read-only, compressed copy of a Graph.
+ * The neighbors of each node are sorted and stored as gap-encoded varints on a single byte stream,
+ * so dense runs of neighbors cost a single byte each. Weights are stored apart: not at all if every
+ * edge has the same weight, as 16 bits codes if quantization is requested, or as plain floats otherwise.
+ */
+class CompressedGraph {
+
+public:
+    class AdjacentsIterator;
+    typedef DFSTraversal<CompressedGraph> DFSIterator;
+    typedef BFSTraversal<CompressedGraph> BFSIterator;
+
+    /*
+     * Freeze the graph g. If quantizeWeights is true, the weights are linearly quantized to 65536
+     * levels between the minimum and the maximum weight of the graph, losing some precision.
+     */
+    CompressedGraph(const Graph& g, bool quantizeWeights = false);
+
+    /*
+     * Return if the graph is oriented or not, true if it is.
+     */
+    bool isOrientedGraph() const;
+
+    /*
+     * Get the cuantity of nodes of the graph.
+     */
+    uint getNodesCount() const;
+
+    /*
+     * Get the cuantity of different edges of the graph.
+     */
+    uint getEdgesCount() const;
+
+    /*
+     * Return the count of neighbors of v.
+     */
+    uint getDegree(uint v) const;
+
+    /*
+     * Idem to Graph::areAdjacent, decoding the neighbors of v1 until v2 is reached.
+     */
+    bool areAdjacent(uint v1, uint v2) const;
+
+    /*
+     * Idem to Graph::getEdgeWeight, DEFAULT_WEIGHT is returned if there is not an edge between v1 and v2.
+     */
+    float getEdgeWeight(uint v1, uint v2) const;
+
+    /*
+     * Return an iterator of the adjacents nodes for a single node, decoding them on the fly.
+     * The neighbors are visited in increasing order.
+     */
+    const AdjacentsIterator adjacentsOf(uint v) const;
+
+    /*
+     * Get the count of bytes used by the compressed representation.
+     */
+    size_t getMemoryUsage() const;
+
+    class AdjacentsIterator {
+
+        public:
+            AdjacentsIterator(const CompressedGraph* g, uint v);
+
+            /*
+             * Get current adjacent of the iterator. This not modify the iterator status.
+             */
+            std::pair<uint,float> next() const;
+
+            /*
+             * Indicates if exist an adjacent node pending for review
+             */
+            bool thereIsMore() const;
+
+            /*
+             * Moves the iterator to the next adjacent, decoding its gap.
+             */
+            void advance();
+
+        private:
+            const CompressedGraph* _g;
+            const unsigned char* _cursor;
+            uint _remaining;
+            uint _edge;
+            uint _current;
+    };
+
+private:
+    enum WEIGHTS {UNIFORM_WEIGHTS, QUANTIZED_WEIGHTS, FULL_WEIGHTS};
+
+    bool _oriented;
+    uint _edgesCount;
+    std::vector<uint64_t> _offsets;
+    std::vector<uint> _firstEdge;
+    std::vector<unsigned char> _stream;
+
+    WEIGHTS _weightsMode;
+    float _minWeight;
+    float _step;
+    std::vector<uint16_t> _quantized;
+    std::vector<float> _weights;
+
+    float _weightOf(uint edge) const;
+
+    static void _writeVarint(std::vector<unsigned char>& out, uint value);
+    static uint _readVarint(const unsigned char*& in);
+};
+
+#endif
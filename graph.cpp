@@ -1,142 +1,599 @@
 #include "graph.h"
+#include "parallel.h"
+#include <thread>
 #include <sstream>
 #include <fstream>
 #include <utility>
 #include <iostream>
 #include <limits>
 #include <stdexcept>
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+#include <unordered_set>
+#include <chrono>
 
 using namespace std;
 
 const float DEFAULT_WEIGHT = numeric_limits<float>::max();
 
-Graph::Graph(uint nodesSpaceSize, bool oriented, IMPL impl) {
+namespace {
+
+    inline uint bitWords(uint n) {
+        return (n + 63) / 64;
+    }
+
+    /*
+     * Rows may be shorter than the count of nodes, the missing positions have no edge.
+     * That lets addVertex leave the rows of the other nodes untouched.
+     */
+    inline float weightAt(const Graph::WeightsRow& row, uint i) {
+        return i < row.size() ? row[i] : DEFAULT_WEIGHT;
+    }
+
+    inline void setWeight(Graph::WeightsRow& row, uint i, float weight) {
+        if(i >= row.size())
+            row.resize(i + 1, DEFAULT_WEIGHT);
+        row[i] = weight;
+    }
+
+    inline bool testBit(const Graph::BitsRow& bits, uint i) {
+        return i / 64 < bits.size() && ((bits[i / 64] >> (i % 64)) & 1);
+    }
+
+    inline void setBit(Graph::BitsRow& bits, uint i) {
+        if(i / 64 >= bits.size())
+            bits.resize(i / 64 + 1, 0);
+        bits[i / 64] |= (uint64_t) 1 << (i % 64);
+    }
+
+    // Returns the first set bit at position i or after it, n if there is none.
+    inline uint nextBit(const Graph::BitsRow& bits, uint i, uint n) {
+        if(i >= n || i / 64 >= bits.size()) return n;
+
+        uint word = i / 64;
+        uint64_t current = bits[word] & (~(uint64_t) 0 << (i % 64));
+
+        while(current == 0) {
+            if(++word >= bits.size()) return n;
+            current = bits[word];
+        }
+
+        return min(n, (uint) (word * 64 + __builtin_ctzll(current)));
+    }
+
+    // Maps a float to an unsigned integer with the same order, negative values included.
+    inline uint32_t orderedBits(float f) {
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+    }
+
+    //Below these, minimumSpanningForest runs a sequential filter-Kruskal instead of the parallel Boruvka rounds
+    const uint BORUVKA_MIN_THREADS = 4;
+    const size_t BORUVKA_MIN_EDGES = 1 << 16;
+
+    std::atomic<uint64_t> lastVersion(0);
+
+    inline uint64_t newVersion() {
+        return ++lastVersion;
+    }
+
+    inline uint findRoot(vector<uint>& parent, uint v) {
+        while(parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+
+        return v;
+    }
+
+    /*
+     * A candidate edge of minimumSpanningForest: its weight order and position on the candidates, and its ends.
+     */
+    struct ForestEdge {
+        uint64_t key;
+        uint from;
+        uint to;
+
+        bool operator<(const ForestEdge& other) const {
+            return key < other.key;
+        }
+    };
+
+    /*
+     * Filter-Kruskal: Kruskal on the lighter half of the edges, then the heavier half without the edges
+     * it already closed into a component. Chosen edges are appended by position, until there are needed of them.
+     */
+    void filterKruskal(ForestEdge* first, ForestEdge* last, vector<uint>& parent, vector<uint>& chosen, uint needed) {
+        if(chosen.size() == needed || first == last)
+            return;
+
+        if(last - first < 1024) {
+            sort(first, last);
+            for (ForestEdge* e = first; e != last && chosen.size() < needed; ++e) {
+                uint a = findRoot(parent, e->from), b = findRoot(parent, e->to);
+                if(a != b) {
+                    parent[a] = b;
+                    chosen.push_back((uint) e->key);
+                }
+            }
+            return;
+        }
+
+        //Keys are unique, so the median of three is neither the lightest nor the heaviest edge
+        uint64_t keys[3] = {first->key, first[(last - first) / 2].key, (last - 1)->key};
+        sort(keys, keys + 3);
+        ForestEdge* middle = partition(first, last, [&](const ForestEdge& e) { return e.key <= keys[1]; });
+
+        filterKruskal(first, middle, parent, chosen, needed);
+        last = remove_if(middle, last, [&](const ForestEdge& e) { return findRoot(parent, e.from) == findRoot(parent, e.to); });
+        filterKruskal(middle, last, parent, chosen, needed);
+    }
+
+}
+
+Graph::Graph(uint nodesSpaceSize, bool oriented, IMPL impl, bool weighted, Arena* a)
+    : matrix(a), adjList(a), bitMatrix(a), neighbors(a), nodes(a), topo(a), conversions(a),
+      edgeSegments(allocate_shared<EdgeSegment>(ArenaAllocator<EdgeSegment>(a), a)), paintedEdges(a) {
     isOriented = oriented;
+    isWeighted = weighted;
     type = impl;
-    nodes = vector<Node>(nodesSpaceSize, Graph::Node());
-
-    if(type == ADJACENCIES_MATRIX)
-        matrix = vector<vector<float> >(nodesSpaceSize, vector<float>(nodesSpaceSize, DEFAULT_WEIGHT));
+    arena = a;
+    version = newVersion();
+    adaptive = false;
+    denseThreshold = 0.25;
+    sparseThreshold = 0.0625;
+    nodes.write().assign(nodesSpaceSize, Graph::Node());
+
+    if(type == ADJACENCIES_MATRIX && isWeighted)
+        matrix.assign(nodesSpaceSize, WeightsRow(nodesSpaceSize, DEFAULT_WEIGHT, arena));
+    else if(type == ADJACENCIES_MATRIX)
+        bitMatrix.assign(nodesSpaceSize, BitsRow(bitWords(nodesSpaceSize), 0, arena));
+    else if(isWeighted)
+        adjList.assign(nodesSpaceSize, WeightedAdjacents(arena));
     else
-        adjList = vector<list<pair<uint,float> > >(nodesSpaceSize, list<pair<uint,float> >());
+        neighbors.assign(nodesSpaceSize, Adjacents(arena));
+}
+
+Graph::Graph(const Graph& other)
+    : matrix(other.matrix), adjList(other.adjList), bitMatrix(other.bitMatrix), neighbors(other.neighbors),
+      nodes(other.nodes), topo(other.topo), conversions(other.conversions), edgeSegments(other.edgeSegments),
+      paintedEdges(other.paintedEdges) {
+    isOriented = other.isOriented;
+    isWeighted = other.isWeighted;
+    type = other.type;
+    arena = other.arena;
+    version = other.version;
+    adaptive = other.adaptive;
+    denseThreshold = other.denseThreshold;
+    sparseThreshold = other.sparseThreshold;
+}
+
+// Moved shared pointers are left null, which every member of the graph reads as empty
+Graph::Graph(Graph&& other) noexcept
+    : matrix(std::move(other.matrix)), adjList(std::move(other.adjList)), bitMatrix(std::move(other.bitMatrix)),
+      neighbors(std::move(other.neighbors)), nodes(std::move(other.nodes)), topo(std::move(other.topo)),
+      conversions(std::move(other.conversions)), edgeSegments(std::move(other.edgeSegments)),
+      paintedEdges(std::move(other.paintedEdges)) {
+    isOriented = other.isOriented;
+    isWeighted = other.isWeighted;
+    type = other.type;
+    arena = other.arena;
+    version = other.version;
+    adaptive = other.adaptive;
+    denseThreshold = other.denseThreshold;
+    sparseThreshold = other.sparseThreshold;
+    other.version = newVersion();
+}
+
+Graph& Graph::operator=(const Graph& other) {
+    if(this != &other) {
+        Graph copy(other);
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
+Graph& Graph::operator=(Graph&& other) noexcept {
+    if(this != &other) {
+        matrix = std::move(other.matrix);
+        adjList = std::move(other.adjList);
+        bitMatrix = std::move(other.bitMatrix);
+        neighbors = std::move(other.neighbors);
+        nodes = std::move(other.nodes);
+        topo = std::move(other.topo);
+        conversions = std::move(other.conversions);
+        edgeSegments = std::move(other.edgeSegments);
+        paintedEdges = std::move(other.paintedEdges);
+        isOriented = other.isOriented;
+        isWeighted = other.isWeighted;
+        type = other.type;
+        arena = other.arena;
+        version = other.version;
+        adaptive = other.adaptive;
+        denseThreshold = other.denseThreshold;
+        sparseThreshold = other.sparseThreshold;
+        other.version = newVersion();
+    }
+
+    return *this;
 }
 
 bool Graph::isOrientedGraph() const {
     return isOriented;
 }
 
+bool Graph::isWeightedGraph() const {
+    return isWeighted;
+}
+
+IMPL Graph::getImplementation() const {
+    return type;
+}
+
+Arena* Graph::getArena() const {
+    return arena;
+}
+
+uint64_t Graph::getVersion() const {
+    return version;
+}
+
 uint Graph::getNodesCount() const {
-    return (uint) nodes.size();
+    return (uint) nodes->size();
 }
 
 uint Graph::getEdgesCount() const {
-    return edges.size();
+    return edgeSegments ? edgeSegments->count : 0;
 }
 
-list<Graph::Edge>& Graph::getEdges() {
-    return edges;
+Graph::EdgeList& Graph::getEdges() {
+    if(!edgeSegments || edgeSegments->previous || edgeSegments.use_count() > 1) {
+        //Gather every edge on a segment of this graph alone. The segments no one else holds are moved,
+        //not copied, so the Edge pointers into them stay valid
+        vector<pair<EdgeSegment*,bool> > segments;
+        bool own = true;
+        for (shared_ptr<EdgeSegment>* s = &edgeSegments; *s; s = &(*s)->previous) {
+            own = own && s->use_count() == 1;
+            segments.push_back(make_pair(s->get(), own));
+        }
+
+        shared_ptr<EdgeSegment> all = allocate_shared<EdgeSegment>(ArenaAllocator<EdgeSegment>(arena), arena);
+        for (auto s = segments.rbegin(); s != segments.rend(); ++s) {
+            if(s->second)
+                all->edges.splice(all->edges.end(), s->first->edges);
+            else
+                all->edges.insert(all->edges.end(), s->first->edges.begin(), s->first->edges.end());
+        }
+        all->count = all->edges.size();
+        edgeSegments = all;
+    }
+
+    return edgeSegments->edges;
+}
+
+Graph::EdgesView Graph::getEdges() const {
+    shared_ptr<EdgesView::Segments> segments = make_shared<EdgesView::Segments>();
+    segments->last = edgeSegments;
+    for (const EdgeSegment* s = edgeSegments.get(); s != NULL; s = s->previous.get())
+        segments->lists.push_back(&s->edges);
+    reverse(segments->lists.begin(), segments->lists.end());
+
+    EdgesView view;
+    view._segments = segments;
+    return view;
+}
+
+void Graph::_addEdge(uint v1, uint v2, float weight) {
+    //A segment shared with copies or views of the graph isn't written, the edge goes to a new one
+    if(!edgeSegments || edgeSegments.use_count() > 1) {
+        shared_ptr<EdgeSegment> last = allocate_shared<EdgeSegment>(ArenaAllocator<EdgeSegment>(arena), arena);
+        last->previous = edgeSegments;
+        last->count = getEdgesCount();
+        edgeSegments = last;
+    }
+
+    edgeSegments->edges.push_back(Edge(v1, v2, weight, edgeSegments->count));
+    edgeSegments->count++;
 }
 
 
 bool Graph::isIsolatedNode(uint v) const {
-    if(v >= nodes.size())
+    if(v >= nodes->size())
         throw invalid_argument("Invalid argument on isIsolatedNode member function, v isn't a node of the graph.");
 
-    return nodes[v].isolated;
+    return (*nodes)[v].isolated;
 }
 
 float Graph::getEdgeWeight(uint v1, uint v2) const {
-    if(v1 >= nodes.size() || v2 >= nodes.size()) 
+    if(v1 >= nodes->size() || v2 >= nodes->size()) 
         throw invalid_argument("Invalid arguments on getEdgeWeight member function, v1 or v2 aren't nodes of the graph.");
 
+    if(!isWeighted)
+        return areAdjacent(v1, v2) ? 1 : DEFAULT_WEIGHT;
+
     if(type == ADJACENCIES_MATRIX)
-        return matrix[v1][v2];
+        return weightAt(matrix[v1], v2);
     else
         for (const auto& edge : adjList[v1]) 
             if (edge.first == v2) 
                 return edge.second;
 
-    return -1;
+    return DEFAULT_WEIGHT;
 }
 
 bool Graph::areAdjacent(uint v1, uint v2) const {
-    if(v1 >= nodes.size() || v2 >= nodes.size()) 
+    if(v1 >= nodes->size() || v2 >= nodes->size()) 
         throw invalid_argument("Invalid arguments on areAdjacent member function, v1 or v2 aren't nodes of the graph.");
 
-    if(type == ADJACENCIES_MATRIX)
-        return matrix[v1][v2] != DEFAULT_WEIGHT;
-    else {
+    if(type == ADJACENCIES_MATRIX && isWeighted)
+        return weightAt(matrix[v1], v2) != DEFAULT_WEIGHT;
+    else if(type == ADJACENCIES_MATRIX)
+        return testBit(bitMatrix[v1], v2);
+    else if(isWeighted) {
         for (const auto& edge : adjList[v1])
             if (edge.first == v2)
                 return true;
 
+        return false;
+    } else {
+        for (uint neighbor : neighbors[v1])
+            if (neighbor == v2)
+                return true;
+
         return false;
     }
 }
 
 void Graph::applyEdge(uint v1, uint v2, float weight) {
-    if(v1 >= nodes.size() || v2 >= nodes.size()) 
+    if(v1 >= nodes->size() || v2 >= nodes->size()) 
         throw invalid_argument("Invalid arguments on applyEdge member function, v1 or v2 aren't nodes of the graph.");
 
-    if(type == ADJACENCIES_MATRIX) {
-        if(matrix[v1][v2] == DEFAULT_WEIGHT)
-            edges.push_back(Edge(v1,v2,weight));
+    if(!isWeighted)
+        weight = 1;
 
-        matrix[v1][v2] = weight;
+    //Reorder before touching the graph, a cycle closing edge leaves it unchanged
+    if(topo->enabled) {
+        _orderEdge(v1, v2);
+        if(type == ADJACENCIES_LIST || !areAdjacent(v1, v2))
+            topo.write().predecessors[v2].push_back(v1);
+    }
 
-        if(nodes[v1]._starting_neighbor_it == -1 || ((uint) nodes[v1]._starting_neighbor_it) > v2)
-            nodes[v1]._starting_neighbor_it = v2;
+    if(type == ADJACENCIES_MATRIX && !isWeighted) {
+        if(!testBit(bitMatrix[v1], v2))
+            _addEdge(v1, v2, weight);
+
+        setBit(bitMatrix.write(v1), v2);
+        if(!isOriented)
+            setBit(bitMatrix.write(v2), v1);
+
+    } else if(type == ADJACENCIES_MATRIX) {
+        NodesVector& ns = nodes.write();
+
+        if(weightAt(matrix[v1], v2) == DEFAULT_WEIGHT)
+            _addEdge(v1, v2, weight);
+
+        setWeight(matrix.write(v1), v2, weight);
+
+        if(ns[v1]._starting_neighbor_it == -1 || ((uint) ns[v1]._starting_neighbor_it) > v2)
+            ns[v1]._starting_neighbor_it = v2;
 
         if(!isOriented) {
-            matrix[v2][v1] = weight;
+            setWeight(matrix.write(v2), v1, weight);
 
-            if(nodes[v2]._starting_neighbor_it == -1 || ((uint) nodes[v2]._starting_neighbor_it) > v1)
-                nodes[v2]._starting_neighbor_it = v1;
+            if(ns[v2]._starting_neighbor_it == -1 || ((uint) ns[v2]._starting_neighbor_it) > v1)
+                ns[v2]._starting_neighbor_it = v1;
         }
 
+    } else if(isWeighted) {
+        adjList.write(v1).push_back(make_pair(v2, weight));
+
+        if(!isOriented)
+            adjList.write(v2).push_back(make_pair(v1, weight));
+
+        _addEdge(v1, v2, weight);
+
     } else {
-        adjList[v1].push_back(make_pair(v2, weight));
+        neighbors.write(v1).push_back(v2);
 
         if(!isOriented)
-            adjList[v2].push_back(make_pair(v1, weight));
+            neighbors.write(v2).push_back(v1);
 
-        edges.push_back(Edge(v1,v2,weight));
+        _addEdge(v1, v2, weight);
     }
 
 
     //Update nodes status, input degree, output degree and isolated state
-    nodes[v1].isolated = false;
-    nodes[v2].isolated = false;
+    NodesVector& ns = nodes.write();
+    ns[v1].isolated = false;
+    ns[v2].isolated = false;
 
-    nodes[v1].dOut++;
-    nodes[v2].dIn++;
+    ns[v1].dOut++;
+    ns[v2].dIn++;
     
     if(!isOriented) {
-        nodes[v2].dOut++;
-        nodes[v1].dIn++;
+        ns[v2].dOut++;
+        ns[v1].dIn++;
     }
+
+    version = newVersion();
+
+    if(adaptive)
+        _adapt();
 }
 
 uint Graph::addVertex() {
-    nodes.push_back(Graph::Node());
+    nodes.write().push_back(Graph::Node());
 
-    if(type == ADJACENCIES_MATRIX) {
-        for (uint i = 0; i < nodes.size() - 1; ++i)
-            matrix[i].push_back(DEFAULT_WEIGHT);
+    //The rows of the other nodes stay shorter, the new column is implicitly empty on them
+    if(type == ADJACENCIES_MATRIX && isWeighted) {
+        matrix.push_back(WeightsRow(nodes->size(), DEFAULT_WEIGHT, arena));
 
-        matrix.push_back(vector<float>(nodes.size(), DEFAULT_WEIGHT));
+    } else if(type == ADJACENCIES_MATRIX) {
+        bitMatrix.push_back(BitsRow(bitWords(nodes->size()), 0, arena));
 
+    } else if(isWeighted) {
+        adjList.push_back(WeightedAdjacents(arena));
     } else {
-        adjList.push_back({});
+        neighbors.push_back(Adjacents(arena));
+    }
+
+    //The new node has no edges, it goes last in the order
+    if(topo->enabled) {
+        TopologicalOrder& t = topo.write();
+        t.position.push_back(t.order.size());
+        t.order.push_back(nodes->size() - 1);
+        t.predecessors.push_back(TopologicalOrder::Indexes(arena));
+    }
+
+    version = newVersion();
+
+    if(adaptive)
+        _adapt();
+
+    return (uint) nodes->size();
+}
+
+template<class Row, class Fill>
+void Graph::_rebuildRows(SharedRows<Row>& target, const Row& prototype, Fill fill) {
+    uint n = nodes->size();
+    vector<Row> rows(n, Row(arena));
+
+    parallelFor(0, n, [&](uint v) {
+        rows[v] = prototype;
+        for(auto it = adjacentsOf(v); it.thereIsMore(); it.advance())
+            fill(rows[v], it.next());
+    });
+
+    target = SharedRows<Row>(arena);
+    for (auto& row : rows)
+        target.push_back(std::move(row));
+}
+
+Graph::ConversionReport Graph::convertTo(IMPL impl) {
+    auto start = chrono::steady_clock::now();
+
+    ConversionReport report;
+    report.from = type;
+    report.to = impl;
+    report.density = getDensity();
+    report.bytesBefore = _storageBytes(type);
+    report.bytesAfter = _storageBytes(impl);
+
+    if(impl != type) {
+        uint n = nodes->size();
+
+        //Every row is built from the current adjacencies of its node, the matrix rows with their full length
+        if(impl == ADJACENCIES_MATRIX && isWeighted) {
+            _rebuildRows(matrix, WeightsRow(n, DEFAULT_WEIGHT, arena), [](WeightsRow& row, const pair<uint,float>& a) {
+                row[a.first] = a.second;
+            });
+        } else if(impl == ADJACENCIES_MATRIX) {
+            _rebuildRows(bitMatrix, BitsRow(bitWords(n), 0, arena), [](BitsRow& row, const pair<uint,float>& a) {
+                setBit(row, a.first);
+            });
+        } else if(isWeighted) {
+            _rebuildRows(adjList, WeightedAdjacents(arena), [](WeightedAdjacents& row, const pair<uint,float>& a) {
+                row.push_back(a);
+            });
+        } else {
+            _rebuildRows(neighbors, Adjacents(arena), [](Adjacents& row, const pair<uint,float>& a) {
+                row.push_back(a.first);
+            });
+        }
+
+        //Drop the old adjacencies, the iterators walking them keep their rows alive
+        if(type == ADJACENCIES_MATRIX) {
+            matrix = SharedRows<WeightsRow>(arena);
+            bitMatrix = SharedRows<BitsRow>(arena);
+        } else {
+            adjList = SharedRows<WeightedAdjacents>(arena);
+            neighbors = SharedRows<Adjacents>(arena);
+        }
+
+        //The weighted matrix iterators start on the first neighbor of the node
+        NodesVector& ns = nodes.write();
+        for (uint v = 0; v < n; ++v) {
+            ns[v]._starting_neighbor_it = -1;
+            if(impl == ADJACENCIES_MATRIX && isWeighted) {
+                for (uint w = 0; w < n && ns[v]._starting_neighbor_it == -1; ++w)
+                    if(matrix[v][w] != DEFAULT_WEIGHT)
+                        ns[v]._starting_neighbor_it = w;
+            }
+        }
+
+        //The neighbors order and, for repeated list edges, the weights may change: it isn't the same graph
+        type = impl;
+        version = newVersion();
     }
 
-    return (uint) nodes.size();
+    report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    conversions.push_back(report);
+
+    return report;
+}
+
+void Graph::setAdaptive(bool adapt, double dense, double sparse) {
+    if(!(sparse >= 0 && sparse < dense && dense <= 1))
+        throw invalid_argument("Invalid arguments on setAdaptive member function, thresholds must verify 0 <= sparseThreshold < denseThreshold <= 1.");
+
+    adaptive = adapt;
+    denseThreshold = dense;
+    sparseThreshold = sparse;
+
+    if(adaptive)
+        _adapt();
+}
+
+bool Graph::isAdaptive() const {
+    return adaptive;
+}
+
+const Graph::ConversionReports& Graph::getConversionReports() const {
+    return conversions;
+}
+
+double Graph::getDensity() const {
+    double n = nodes->size();
+    if(n < 2)
+        return 0;
+
+    double possible = isOriented ? n * (n - 1) : n * (n - 1) / 2;
+    return min(1.0, getEdgesCount() / possible);
+}
+
+size_t Graph::getMemoryUsage() const {
+    return _storageBytes(type);
+}
+
+// Estimated bytes of the adjacencies over an implementation: every row costs its pointer, its header
+// and its control block, a matrix row a full row of weights or bits, and every list entry a node with two links.
+size_t Graph::_storageBytes(IMPL impl) const {
+    size_t n = nodes->size();
+    size_t rows = n * (sizeof(shared_ptr<WeightsRow>) + sizeof(WeightsRow) + 2 * sizeof(void*));
+
+    if(impl == ADJACENCIES_MATRIX)
+        return rows + n * (isWeighted ? n * sizeof(float) : bitWords(n) * sizeof(uint64_t));
+
+    size_t entries = (size_t) getEdgesCount() * (isOriented ? 1 : 2);
+    return rows + entries * (2 * sizeof(void*) + (isWeighted ? sizeof(pair<uint,float>) : sizeof(uint)));
+}
+
+void Graph::_adapt() {
+    double density = getDensity();
+
+    if(type == ADJACENCIES_LIST && density >= denseThreshold)
+        convertTo(ADJACENCIES_MATRIX);
+    else if(type == ADJACENCIES_MATRIX && density <= sparseThreshold)
+        convertTo(ADJACENCIES_LIST);
 }
 
 void Graph::fill() {
-    for (uint node = 0; node < nodes.size() ; node++) {
+    for (uint node = 0; node < nodes->size() ; node++) {
         if(isIsolatedNode(node)){
-            for (uint i = 0; i < nodes.size(); ++i) {
+            for (uint i = 0; i < nodes->size(); ++i) {
                 if(node == i) continue;
 
                 applyEdge(node, i);
@@ -145,7 +602,7 @@ void Graph::fill() {
             }
 
         } else {
-            for (uint i = 0; i < nodes.size(); ++i) {
+            for (uint i = 0; i < nodes->size(); ++i) {
                 if(node == i) continue;
 
                 if(!areAdjacent(node, i))
@@ -158,46 +615,299 @@ void Graph::fill() {
     }
 }
 
+vector<Graph::Edge*> Graph::minimumSpanningForest(bool paint, FOREST_METHOD method) {
+    uint n = nodes->size();
+    EdgeList& all = getEdges();
+
+    //Contiguous array of candidate edges, self loops can never be chosen
+    vector<Edge*> candidates;
+    candidates.reserve(all.size());
+    for (auto& e : all)
+        if(e.from != e.to)
+            candidates.push_back(&e);
+
+    vector<uint> parent(n), component(n);
+    for (uint v = 0; v < n; ++v)
+        parent[v] = v;
+
+    vector<Edge*> forest;
+
+    //Edges are ordered by weight, ties broken by position: both ways choose the same forest
+    bool small = thread::hardware_concurrency() < BORUVKA_MIN_THREADS || candidates.size() < BORUVKA_MIN_EDGES;
+    if(method == KRUSKAL_FOREST || (method == AUTOMATIC_FOREST && small)) {
+        vector<ForestEdge> edges(candidates.size());
+        for (uint i = 0; i < candidates.size(); ++i)
+            edges[i] = ForestEdge{((uint64_t) orderedBits(candidates[i]->weight) << 32) | i, candidates[i]->from, candidates[i]->to};
+
+        vector<uint> chosen;
+        filterKruskal(edges.data(), edges.data() + edges.size(), parent, chosen, n > 0 ? n - 1 : 0);
+        for (uint i : chosen)
+            forest.push_back(candidates[i]);
+
+        candidates.clear();
+    }
+
+    vector<atomic<uint64_t> > cheapest(candidates.empty() ? 0 : n);
+    const uint64_t NONE = numeric_limits<uint64_t>::max();
+
+    while(!candidates.empty()) {
+        for (uint v = 0; v < n; ++v) {
+            component[v] = findRoot(parent, v);
+            cheapest[v].store(NONE, memory_order_relaxed);
+        }
+
+        //Each component looks for its lightest edge, ties broken by position so no cycle is closed
+        parallelFor(0, candidates.size(), [&](uint i) {
+            uint cu = component[candidates[i]->from], cv = component[candidates[i]->to];
+            uint64_t key = ((uint64_t) orderedBits(candidates[i]->weight) << 32) | i;
+
+            for (uint c : {cu, cv}) {
+                uint64_t current = cheapest[c].load(memory_order_relaxed);
+                while(key < current && !cheapest[c].compare_exchange_weak(current, key, memory_order_relaxed));
+            }
+        }, 4096);
+
+        uint joined = 0;
+        for (uint c = 0; c < n; ++c) {
+            uint64_t key = cheapest[c].load(memory_order_relaxed);
+            if(key == NONE) continue;
+
+            Edge* e = candidates[(uint) (key & 0xffffffffu)];
+            uint a = findRoot(parent, e->from), b = findRoot(parent, e->to);
+            if(a != b) {
+                parent[a] = b;
+                forest.push_back(e);
+                joined++;
+            }
+        }
+
+        if(joined == 0) break;
+
+        //Drop the edges already inside a component
+        candidates.erase(remove_if(candidates.begin(), candidates.end(), [&](Edge* e) {
+            return findRoot(parent, e->from) == findRoot(parent, e->to);
+        }), candidates.end());
+    }
+
+    if(paint)
+        for (Edge* e : forest)
+            paintEdge(e);
+
+    return forest;
+}
+
+void Graph::maintainTopologicalOrder(bool enable) {
+    if(enable && !isOriented)
+        throw invalid_argument("Invalid argument on maintainTopologicalOrder member function, the graph isn't oriented.");
+
+    CopyOnWrite<TopologicalOrder> order(arena);
+    if(!enable) {
+        topo = order;
+        return;
+    }
+
+    uint n = nodes->size();
+    TopologicalOrder& t = order.write();
+    t.position.assign(n, 0);
+    t.predecessors.assign(n, TopologicalOrder::Indexes(arena));
+
+    vector<uint> pendingIn(n, 0);
+    for (uint v = 0; v < n; ++v) {
+        for(auto it = adjacentsOf(v); it.thereIsMore(); it.advance()) {
+            t.predecessors[it.next().first].push_back(v);
+            pendingIn[it.next().first]++;
+        }
+    }
+
+    //Kahn: a node is placed once all its predecessors are
+    for (uint v = 0; v < n; ++v)
+        if(pendingIn[v] == 0)
+            t.order.push_back(v);
+
+    for (uint i = 0; i < t.order.size(); ++i) {
+        uint v = t.order[i];
+        t.position[v] = i;
+
+        for(auto it = adjacentsOf(v); it.thereIsMore(); it.advance())
+            if(--pendingIn[it.next().first] == 0)
+                t.order.push_back(it.next().first);
+    }
+
+    if(t.order.size() != n)
+        throw invalid_argument("Invalid argument on maintainTopologicalOrder member function, the graph has a cycle.");
+
+    t.enabled = true;
+    topo = order;
+}
+
+bool Graph::maintainsTopologicalOrder() const {
+    return topo->enabled;
+}
+
+uint Graph::topologicalIndex(uint v) const {
+    if(!topo->enabled)
+        throw invalid_argument("Invalid argument on topologicalIndex member function, the topological order isn't maintained.");
+    if(v >= nodes->size())
+        throw invalid_argument("Invalid argument on topologicalIndex member function, v isn't a node of the graph.");
+
+    return topo->position[v];
+}
+
+uint Graph::topologicalNode(uint i) const {
+    if(!topo->enabled)
+        throw invalid_argument("Invalid argument on topologicalNode member function, the topological order isn't maintained.");
+    if(i >= nodes->size())
+        throw invalid_argument("Invalid argument on topologicalNode member function, i isn't a position of the order.");
+
+    return topo->order[i];
+}
+
+bool Graph::wouldCloseCycle(uint v1, uint v2) const {
+    if(v1 >= nodes->size() || v2 >= nodes->size())
+        throw invalid_argument("Invalid arguments on wouldCloseCycle member function, v1 or v2 aren't nodes of the graph.");
+
+    if(v1 == v2)
+        return true;
+
+    vector<uint> region;
+    if(!topo->enabled)
+        return !_forwardRegion(v2, v1, 0, region);
+
+    //A forward edge of the order can't close a cycle
+    if(topo->position[v2] > topo->position[v1])
+        return false;
+
+    return !_forwardRegion(v2, v1, topo->position[v1], region);
+}
+
+// Collects the nodes reachable from source, without passing the position bound of the order when it is
+// maintained. Returns false, stopping the search, if target is reached.
+bool Graph::_forwardRegion(uint source, uint target, uint bound, vector<uint>& region) const {
+    const TopologicalOrder& t = *topo;
+    unordered_set<uint> visited;
+    vector<uint> pending(1, source);
+    visited.insert(source);
+
+    while(!pending.empty()) {
+        uint v = pending.back();
+        pending.pop_back();
+
+        if(v == target)
+            return false;
+        region.push_back(v);
+
+        for(auto it = adjacentsOf(v); it.thereIsMore(); it.advance()) {
+            uint w = it.next().first;
+            if((!t.enabled || t.position[w] <= bound) && visited.insert(w).second)
+                pending.push_back(w);
+        }
+    }
+
+    return true;
+}
+
+void Graph::_orderEdge(uint v1, uint v2) {
+    if(v1 == v2)
+        throw invalid_argument("Invalid arguments on applyEdge member function, the edge closes a cycle.");
+
+    uint lower = topo->position[v2];
+    uint upper = topo->position[v1];
+    if(lower > upper)
+        return;
+
+    //Nodes reached from v2 up to v1 in the order, v1 among them means a cycle
+    vector<uint> forward;
+    if(!_forwardRegion(v2, v1, upper, forward))
+        throw invalid_argument("Invalid arguments on applyEdge member function, the edge closes a cycle.");
+
+    //Nodes reaching v1 down to v2 in the order
+    TopologicalOrder& t = topo.write();
+    vector<uint> backward(1, v1), pending(1, v1);
+    unordered_set<uint> visited(pending.begin(), pending.end());
+
+    while(!pending.empty()) {
+        uint v = pending.back();
+        pending.pop_back();
+
+        for (uint w : t.predecessors[v]) {
+            if(t.position[w] > lower && visited.insert(w).second) {
+                backward.push_back(w);
+                pending.push_back(w);
+            }
+        }
+    }
+
+    //Both regions keep their inner order, and the backward one moves before the forward one
+    auto byPosition = [&t](uint a, uint b) { return t.position[a] < t.position[b]; };
+    sort(forward.begin(), forward.end(), byPosition);
+    sort(backward.begin(), backward.end(), byPosition);
+
+    vector<uint> slots;
+    for (uint v : backward) slots.push_back(t.position[v]);
+    for (uint v : forward) slots.push_back(t.position[v]);
+    sort(slots.begin(), slots.end());
+
+    uint i = 0;
+    for (uint v : backward) {
+        t.position[v] = slots[i];
+        t.order[slots[i++]] = v;
+    }
+    for (uint v : forward) {
+        t.position[v] = slots[i];
+        t.order[slots[i++]] = v;
+    }
+}
+
 void Graph::paintNode(uint v) {
-    if(v >= nodes.size()) 
+    if(v >= nodes->size()) 
         throw invalid_argument("Invalid argument on paintNode member function, v is not a node of the graph.");
 
-    nodes[v].painted = true;
+    nodes.write()[v].painted = true;
 }
 
-bool Graph::paintedNode(uint v) {
-    if(v >= nodes.size()) 
+bool Graph::paintedNode(uint v) const {
+    if(v >= nodes->size()) 
         throw invalid_argument("Invalid argument on paintedNode member function, v is not a node of the graph.");
 
-    return nodes[v].painted;
+    return (*nodes)[v].painted;
 }
 
 void Graph::unpaintNode(uint v) {
-    if(v >= nodes.size()) 
+    if(v >= nodes->size()) 
         throw invalid_argument("Invalid argument on unpaintNode member function, v is not a node of the graph.");
     
-    nodes[v].painted = false;    
+    nodes.write()[v].painted = false;
 }
 
-void Graph::paintEdge(Edge* e) {
+uint Graph::_edgeIndex(const Edge* e, const char* function) const {
     if(e == NULL) 
-        throw invalid_argument("Invalid argument on paintEdge member function, NULL pointer passed by parameter.");
-    
-    e->painted = true;
+        throw invalid_argument(string("Invalid argument on ") + function + " member function, NULL pointer passed by parameter.");
+    if(e->index >= getEdgesCount())
+        throw invalid_argument(string("Invalid argument on ") + function + " member function, the edge is not an edge of the graph.");
+
+    return e->index;
 }
 
-bool Graph::paintedEdge(Edge* e) {
-    if(e == NULL) 
-        throw invalid_argument("Invalid argument on paintedEdge member function, NULL pointer passed by parameter.");
-    
-    return e->painted;
+void Graph::paintEdge(const Edge* e) {
+    uint i = _edgeIndex(e, "paintEdge");
+
+    BitsRow& bits = paintedEdges.write();
+    if(bits.size() <= i / 64)
+        bits.resize(i / 64 + 1, 0);
+    bits[i / 64] |= (uint64_t) 1 << (i % 64);
 }
 
-void Graph::unpaintEdge(Edge* e) {
-    if(e == NULL) 
-        throw invalid_argument("Invalid argument on unpaintEdge member function, NULL pointer passed by parameter.");
-    
-    e->painted = false;    
+bool Graph::paintedEdge(const Edge* e) const {
+    uint i = _edgeIndex(e, "paintedEdge");
+
+    return i / 64 < paintedEdges->size() && ((*paintedEdges)[i / 64] >> (i % 64) & 1);
+}
+
+void Graph::unpaintEdge(const Edge* e) {
+    uint i = _edgeIndex(e, "unpaintEdge");
+
+    if(i / 64 < paintedEdges->size())
+        paintedEdges.write()[i / 64] &= ~((uint64_t) 1 << (i % 64));
 }
 
 string Graph::getDOT(bool weighted) const {
@@ -213,13 +923,13 @@ string Graph::getDOT(bool weighted) const {
 
     dot << "node[shape=circle,width=0.5,height=0.5,fixedsize=true]";
 
-    for (auto edge = edges.begin(); edge != edges.end(); ++edge) {
-        auto from = edge->from;
-        auto to = edge->to;
-        auto weight = edge->weight;
-        auto paintedEdge = edge->painted;
+    for (const Edge& edge : getEdges()) {
+        auto from = edge.from;
+        auto to = edge.to;
+        auto weight = edge.weight;
+        auto paintedEdge = this->paintedEdge(&edge);
 
-        if(weighted)
+        if(weighted && isWeighted)
             sprintf(tag, (paintedEdge ? "[color=red,penwidth=1.0,label=\"%.2f\"]" : "[label=\"%.2f\"]"), weight);
         else
             sprintf(tag, (paintedEdge ? "[color=red,penwidth=1.0]" : ""));
@@ -230,19 +940,19 @@ string Graph::getDOT(bool weighted) const {
         dot << tag;
         dot << ";";
 
-        if(nodes[from].painted) {
+        if((*nodes)[from].painted) {
             dot << to_string(from);
             dot << "[style=filled,fillcolor=red]";
         }
 
-        if(nodes[to].painted) {
+        if((*nodes)[to].painted) {
             dot << to_string(to);
             dot << "[style=filled,fillcolor=red]";
         }
     }
 
-    for (uint i = 0; i < nodes.size(); i++) {
-        auto node = nodes[i];
+    for (uint i = 0; i < nodes->size(); i++) {
+        const Node& node = (*nodes)[i];
         if(node.isolated) {
             dot << to_string(i);
             dot << rel_type;
@@ -294,17 +1004,21 @@ void Graph::exportDOT(const char* file_name, bool force_override) const {
 }
 
 const typename Graph::AdjacentsIterator Graph::adjacentsOf(uint v) const {
-    if(v >= nodes.size()) 
+    if(v >= nodes->size()) 
         throw invalid_argument("Invalid argument on adjacentsOf member function, v is not a node of the graph.");
 
-    if(type == ADJACENCIES_MATRIX)
-        return AdjacentsIterator(nodes[v], matrix[v], nodes.size(), type);
+    if(type == ADJACENCIES_MATRIX && isWeighted)
+        return AdjacentsIterator((*nodes)[v], matrix.share(v), nodes->size(), type);
+    else if(type == ADJACENCIES_MATRIX)
+        return AdjacentsIterator(bitMatrix.share(v), nodes->size());
+    else if(isWeighted)
+        return AdjacentsIterator(adjList.share(v), nodes->size(), type);
     else
-        return AdjacentsIterator(nodes[v], adjList[v], nodes.size(), type);
+        return AdjacentsIterator(neighbors.share(v), nodes->size());
 }
 
 // const typename Graph::DFSIterator Graph::DFS(uint v) const {
-//     if(v >= nodes.size()) 
+//     if(v >= nodes->size()) 
 //         throw invalid_argument("Invalid argument on DFS member function, v is not a node of the graph.");
 
 //     return DFSIterator(v, this);
@@ -316,30 +1030,54 @@ const typename Graph::AdjacentsIterator Graph::adjacentsOf(uint v) const {
  * Adjacents iterator implementation.
  */
 
-Graph::AdjacentsIterator::AdjacentsIterator(Graph::Node me, const vector<float>& relations, uint n, IMPL impl) {
+Graph::AdjacentsIterator::AdjacentsIterator(const Graph::Node& me, shared_ptr<const WeightsRow> relations, uint n, IMPL impl) {
     _values = relations;
-    _it = _values.begin();
-    _vSpace = n;
+    _vSpace = min(n, (uint) _values->size());
     _impl = impl;
+    _weighted = true;
 
     _current = me._starting_neighbor_it;
 }
 
-Graph::AdjacentsIterator::AdjacentsIterator(Graph::Node me, const list<pair<uint,float> >& adjacents, uint n, IMPL impl) {
+Graph::AdjacentsIterator::AdjacentsIterator(shared_ptr<const WeightedAdjacents> adjacents, uint n, IMPL impl) {
     _adjacents = adjacents;
-    _iter = _adjacents.begin();
+    _iter = _adjacents->begin();
 
     _vSpace = n;
     _impl = impl;
+    _weighted = true;
+}
+
+Graph::AdjacentsIterator::AdjacentsIterator(shared_ptr<const BitsRow> bits, uint n) {
+    _bits = bits;
+    _vSpace = n;
+    _impl = ADJACENCIES_MATRIX;
+    _weighted = false;
+
+    _current = nextBit(*_bits, 0, n);
+}
+
+Graph::AdjacentsIterator::AdjacentsIterator(shared_ptr<const Adjacents> adjacents, uint n) {
+    _neighbors = adjacents;
+    _niter = _neighbors->begin();
+
+    _vSpace = n;
+    _impl = ADJACENCIES_LIST;
+    _weighted = false;
 }
 
 void Graph::AdjacentsIterator::advance() {
-    if(_impl == ADJACENCIES_MATRIX) {
+    if(_impl == ADJACENCIES_MATRIX && !_weighted) {
+        _current = nextBit(*_bits, _current + 1, _vSpace);
+
+    } else if(_impl == ADJACENCIES_MATRIX) {
 
         while((++_current) < (long int)_vSpace)
-            if(_values[_current] != DEFAULT_WEIGHT)
+            if((*_values)[_current] != DEFAULT_WEIGHT)
                 break;
 
+    } else if(!_weighted) {
+        _niter++;
     } else {
         _iter++;
     }
@@ -348,8 +1086,12 @@ void Graph::AdjacentsIterator::advance() {
 }
 
 pair<uint,float> Graph::AdjacentsIterator::next() const {
-    if(_impl == ADJACENCIES_MATRIX)
-        return make_pair(_current, _values[_current]);
+    if(_impl == ADJACENCIES_MATRIX && !_weighted)
+        return make_pair(_current, 1.0f);
+    else if(_impl == ADJACENCIES_MATRIX)
+        return make_pair(_current, (*_values)[_current]);
+    else if(!_weighted)
+        return make_pair(*_niter, 1.0f);
     else
         return (*_iter);
 }
@@ -357,87 +1099,80 @@ pair<uint,float> Graph::AdjacentsIterator::next() const {
 bool Graph::AdjacentsIterator::thereIsMore() const {
     if(_impl == ADJACENCIES_MATRIX)
         return -1 < _current && _current < ((long int)_vSpace);
+    else if(!_weighted)
+        return _niter != _neighbors->end();
     else
-        return _iter != _adjacents.end();
+        return _iter != _adjacents->end();
 }
 
 
 
 /*
- * DFS iterator implementation.
+ * DFS and BFS iterators implementation, over the generic traversals.
  */
 
-Graph::DFSIterator::DFSIterator(uint source, Graph* g) {
-    _g = g;
-    _source = source;
-    _visited_nodes = vector<bool>((*g).getNodesCount(), false);
-    
-    _q.push(source);
-}
+Graph::DFSIterator::DFSIterator(uint source, const Graph* g) : DFSTraversal<Graph>(source, g, g->getArena()) { }
 
-void Graph::DFSIterator::advance() {
-    do {
-        uint last = _q.top();
-        _q.pop();
+Graph::BFSIterator::BFSIterator(uint source, const Graph* g) : BFSTraversal<Graph>(source, g, g->getArena()) { }
 
-        if(!_visited_nodes[last]) {
-            _visited_nodes[last] = true;
 
-            for(auto it = (*_g).adjacentsOf(last); it.thereIsMore(); it.advance())
-                if(!_visited_nodes[it.next().first]) 
-                    _q.push(it.next().first);
-             
-        }
-        
-    } while(!_q.empty() && _visited_nodes[_q.top()]);
-    
-    return;
+/*
+ * Edges view implementation.
+ */
+
+Graph::EdgesView::const_iterator Graph::EdgesView::begin() const {
+    return const_iterator(_segments, 0);
 }
 
-uint Graph::DFSIterator::next() const {
-    return _q.top();
+Graph::EdgesView::const_iterator Graph::EdgesView::end() const {
+    return const_iterator(_segments, _segments->lists.size());
 }
 
-bool Graph::DFSIterator::thereIsMore() const {
-    return !_q.empty();
+uint Graph::EdgesView::size() const {
+    return _segments->last ? _segments->last->count : 0;
 }
 
+Graph::EdgesView::const_iterator::const_iterator(shared_ptr<const Segments> segments, size_t list)
+    : _segments(segments), _list(list) {
+    _skipEmpty();
+}
 
-/*
- * BFS iterator implementation.
- */
+void Graph::EdgesView::const_iterator::_skipEmpty() {
+    const vector<const EdgeList*>& lists = _segments->lists;
+    while(_list < lists.size() && lists[_list]->empty())
+        _list++;
 
-Graph::BFSIterator::BFSIterator(uint source, Graph* g) {
-    _g = g;
-    _source = source;
-    _visited_nodes = vector<bool>((*g).getNodesCount(), false);
-    
-    _q.push(source);
+    if(_list < lists.size())
+        _edge = lists[_list]->begin();
 }
 
-void Graph::BFSIterator::advance() {
-    do {
-        uint last = _q.front();
-        _q.pop();
+const Graph::Edge& Graph::EdgesView::const_iterator::operator*() const {
+    return *_edge;
+}
 
-        if(!_visited_nodes[last]) {
-            _visited_nodes[last] = true;
+const Graph::Edge* Graph::EdgesView::const_iterator::operator->() const {
+    return &*_edge;
+}
 
-            for(auto it = (*_g).adjacentsOf(last); it.thereIsMore(); it.advance())
-                if(!_visited_nodes[it.next().first]) 
-                    _q.push(it.next().first);
-             
-        }
-        
-    } while(!_q.empty() && _visited_nodes[_q.front()]);
-    
-    return;
+Graph::EdgesView::const_iterator& Graph::EdgesView::const_iterator::operator++() {
+    if(++_edge == _segments->lists[_list]->end()) {
+        _list++;
+        _skipEmpty();
+    }
+
+    return *this;
+}
+
+Graph::EdgesView::const_iterator Graph::EdgesView::const_iterator::operator++(int) {
+    const_iterator previous = *this;
+    ++*this;
+    return previous;
 }
 
-uint Graph::BFSIterator::next() const {
-    return _q.front();
+bool Graph::EdgesView::const_iterator::operator==(const const_iterator& other) const {
+    return _list == other._list && (_list == _segments->lists.size() || _edge == other._edge);
 }
 
-bool Graph::BFSIterator::thereIsMore() const {
-    return !_q.empty();
+bool Graph::EdgesView::const_iterator::operator!=(const const_iterator& other) const {
+    return !(*this == other);
 }
@@ -4,38 +4,47 @@
 #include <vector>
 #include <list>
 #include <string>
-#include <stack>
-#include <queue>
+#include <iterator>
+#include <cstdint>
+#include <memory>
+#include "arena.h"
+#include "traversal.h"
 
 typedef unsigned int uint;
 
 enum IMPL {ADJACENCIES_MATRIX, ADJACENCIES_LIST};
 
+/*
+ * Algorithm of minimumSpanningForest. The automatic choice depends on the size of the graph and the hardware threads.
+ */
+enum FOREST_METHOD {AUTOMATIC_FOREST, KRUSKAL_FOREST, BORUVKA_FOREST};
+
+/*
+ * Weight of a non existing edge, the infinity float value.
+ */
+extern const float DEFAULT_WEIGHT;
+
+
 class Graph {
 
 public:
     class AdjacentsIterator;
     class DFSIterator;
     class BFSIterator;
+    class EdgesView;
     
     struct Edge {
         uint from;
         uint to;
         float weight;
-        bool painted;
+        //Position of the edge on the edges of the graph, the graph keeps its paint apart
+        uint index;
 
-        Edge(uint f, uint t, float w) {
+        Edge(uint f, uint t, float w, uint i = 0) {
             this->from = f;
             this->to = t;
             this->weight = w;
-            this->painted = false;
-        }
-
-        Edge(const Edge& other) {
-            this->from = other.from;
-            this->to = other.to;
-            this->weight = other.weight;
-            this->painted = other.painted;
+            this->index = i;
         }
     };
 
@@ -49,6 +58,31 @@ public:
         int _starting_neighbor_it;
     };
 
+    /*
+     * Containers used by the graph. All of them allocate from the arena of the graph, if it has one.
+     */
+    typedef std::vector<float, ArenaAllocator<float> > WeightsRow;
+    typedef std::vector<uint64_t, ArenaAllocator<uint64_t> > BitsRow;
+    typedef std::list<std::pair<uint,float>, ArenaAllocator<std::pair<uint,float> > > WeightedAdjacents;
+    typedef std::list<uint, ArenaAllocator<uint> > Adjacents;
+    typedef std::list<Edge, ArenaAllocator<Edge> > EdgeList;
+    typedef std::vector<Node, ArenaAllocator<Node> > NodesVector;
+
+    /*
+     * The tradeoff of a change of implementation: the edge density at that moment, the estimated bytes of the
+     * adjacencies before and after, and the seconds the conversion took.
+     */
+    struct ConversionReport {
+        IMPL from;
+        IMPL to;
+        double density;
+        size_t bytesBefore;
+        size_t bytesAfter;
+        double seconds;
+    };
+
+    typedef std::vector<ConversionReport, ArenaAllocator<ConversionReport> > ConversionReports;
+
     /*
      * Construct a simple graph, with n nodes.
      * Nodes are represented by numbers between 0 and n-1 inclusive.
@@ -57,13 +91,36 @@ public:
        - If not nodes count is specified, the default value is 0.
        - If not orientation is specified, the default value is false.
        - If not implementation is specified, the default imple is ADJACENCIES_MATRIX
+       - If not weighted mode is specified, the default value is true.
+       - If not arena is specified, the graph uses the global operator new and delete.
      * Each impl gets different execution times for each graph operation.
+     * The adjacencies of an unweighted graph store no weights: the matrix becomes a bit matrix and
+       the lists hold plain node numbers. Every edge of an unweighted graph weights 1. The list of
+       edges returned by getEdges() is still kept, with a node per edge (about 40 bytes each).
+     * If an arena is given, every container of the graph and of its iterators allocates from it,
+       so the arena must outlive the graph.
+     */
+    Graph(uint n = 0, bool isOrientedGraph = false, IMPL impl = ADJACENCIES_MATRIX, bool isWeightedGraph = true, Arena* arena = NULL);
+
+    /*
+     * Copy a graph in O(1). Both graphs share the adjacency rows, the nodes and the edges until one of
+     * them modifies them. The first write to either graph costs O(n), to copy the sequence of row pointers
+     * and the nodes; then only the rows actually modified are copied, when they are first written.
+     * Edge pointers taken from getEdges() before the copy point to storage shared by both graphs,
+     * but each graph keeps the paint of its edges apart.
+     * The copy only reads other, so several threads can copy the same graph at once.
+     * Moving never throws: the moved graph is left empty, with no nodes, keeping its orientation, implementation
+     * and weighted mode.
      */
-    Graph(uint n = 0, bool isOrientedGraph = false, IMPL impl = ADJACENCIES_MATRIX);
+    Graph(const Graph& other);
+    Graph(Graph&& other) noexcept;
+    Graph& operator=(const Graph& other);
+    Graph& operator=(Graph&& other) noexcept;
 
     /*
      * Applies an edge with a weight (optional), between two diferent nodes v1 and v2 (nodes must be already applied to the graph).
-     * This method is util when the graph has weight in each edge.
+     * This method is util when the graph has weight in each edge. The weight is ignored on an unweighted graph.
+     * O(1), but O(n) on the first write to a graph sharing its storage with a copy.
      */
     void applyEdge(uint v1, uint v2, float weight = 1);
 
@@ -78,6 +135,65 @@ public:
      */
     bool isOrientedGraph() const;
 
+    /*
+     * Return if the graph stores weights or not, true if it does.
+     */
+    bool isWeightedGraph() const;
+
+    /*
+     * Return the implementation the graph is based on, ADJACENCIES_MATRIX or ADJACENCIES_LIST.
+     */
+    IMPL getImplementation() const;
+
+    /*
+     * Rebuild the adjacencies over another implementation, in a single parallel pass over the nodes.
+     * Nodes, edges, paint and the topological order are kept. Repeated edges of a list graph become a single
+     * edge of the matrix, with the last weight applied, while getEdges() keeps listing them.
+     * Iterators created before the conversion keep walking the old adjacencies.
+     */
+    ConversionReport convertTo(IMPL impl);
+
+    /*
+     * Let the graph choose its implementation: it becomes ADJACENCIES_MATRIX when the edge density
+     * (see getDensity) reaches denseThreshold, and ADJACENCIES_LIST when it falls to sparseThreshold.
+     * The gap between both thresholds keeps the graph from converting back and forth. The default thresholds
+     * surround the density where a weighted matrix and weighted lists take about the same memory.
+     */
+    void setAdaptive(bool adaptive, double denseThreshold = 0.25, double sparseThreshold = 0.0625);
+
+    /*
+     * Return true if the graph chooses its implementation by itself.
+     */
+    bool isAdaptive() const;
+
+    /*
+     * Return the report of every conversion of the graph, explicit or adaptive, in order.
+     */
+    const ConversionReports& getConversionReports() const;
+
+    /*
+     * Return the count of edges divided by the count of posible edges, between 0 and 1.
+     */
+    double getDensity() const;
+
+    /*
+     * Return the estimated bytes taken by the adjacencies of the graph.
+     */
+    size_t getMemoryUsage() const;
+
+    /*
+     * Return the arena the graph allocates from, NULL if it uses the global operator new and delete.
+     */
+    Arena* getArena() const;
+
+    /*
+     * Return the version of the graph. Every applyEdge, addVertex and change of implementation gives the graph
+     * a new version, never used before by any graph, so a version always stands for the same nodes and edges,
+     * in the same order, with the same weights.
+     * A copy keeps the version of the original until one of them is modified.
+     */
+    uint64_t getVersion() const;
+
     /*
      * Get the cuantity of nodes are now in the graph.
      */
@@ -89,9 +205,17 @@ public:
     uint getEdgesCount() const;
 
     /*
-     * Return all edges of the graph, in a vector.
+     * Return all edges of the graph, in a list.
+     * If the graph shares its edges with copies of it, they are copied to the graph first.
+     * The list allocates from the arena of the graph, so it is no longer a std::list<Edge> with the default allocator.
+     */
+    EdgeList& getEdges();
+
+    /*
+     * Return a read only view of all edges of the graph, in the order they were applied. Unlike getEdges(),
+     * it never modifies the graph, so several threads can read (and copy) the same graph at once.
      */
-    std::list<Graph::Edge>& getEdges();
+    EdgesView getEdges() const;
 
     /*
      * Add a new vertex, with out adjacents.
@@ -102,6 +226,7 @@ public:
     /*
      * Return the weight of the edge between nodes v1 and v2. If the graph is non-oriented, the orden of the parameters
      * doesn't matter, but it's important in a oriented graph, v1 indicates the origin of the edge, and v2 indicates the end.
+     * Returns DEFAULT_WEIGHT if there is no such edge, and 1 for every existing edge of an unweighted graph.
      */
     float getEdgeWeight(uint v1, uint v2) const;
 
@@ -122,6 +247,45 @@ public:
      */
     void fill();
 
+    /*
+     * Compute a minimum spanning forest of the graph: a minimum spanning tree for each connected component.
+     * The edges of an oriented graph are taken as non-oriented. Uses a parallel Boruvka over a contiguous
+     * array of the edges on large graphs with enough hardware threads, a sequential filter-Kruskal otherwise,
+     * unless the method forces one of them. Both choose the same forest.
+     * Returns pointers to the chosen edges, inside the list returned by getEdges().
+     * If paint is true, the chosen edges are also painted.
+     */
+    std::vector<Edge*> minimumSpanningForest(bool paint = false, FOREST_METHOD method = AUTOMATIC_FOREST);
+
+    /*
+     * Keep a topological order of an oriented graph, updated incrementally on every applyEdge
+     * (Pearce-Kelly): only the nodes placed between the ends of a new edge are visited and reordered.
+     * Once enabled, applyEdge rejects the edges that would close a cycle. The graph must be acyclic
+     * when the maintenance is enabled. Passing false stops the maintenance.
+     */
+    void maintainTopologicalOrder(bool enable = true);
+
+    /*
+     * Return true if the topological order is maintained on the graph.
+     */
+    bool maintainsTopologicalOrder() const;
+
+    /*
+     * Return the position of the node v in the topological order, from 0 to n-1.
+     */
+    uint topologicalIndex(uint v) const;
+
+    /*
+     * Return the node placed at position i of the topological order.
+     */
+    uint topologicalNode(uint i) const;
+
+    /*
+     * Return true if applying the edge (v1, v2) would close a cycle, that is, if v1 is reachable from v2.
+     * If the topological order is maintained, only the nodes placed between v2 and v1 are visited.
+     */
+    bool wouldCloseCycle(uint v1, uint v2) const;
+
     /*
      * Paint a node to remark it on the graphic output
      */
@@ -130,7 +294,7 @@ public:
     /*
      * Return true if the node is painted, false otherwise
      */
-    bool paintedNode(uint v);
+    bool paintedNode(uint v) const;
 
     /*
      * Unpaint a painted node
@@ -138,19 +302,20 @@ public:
     void unpaintNode(uint v);
 
     /*
-     * Paint an edge to remark it on the graphic output
+     * Paint an edge to remark it on the graphic output.
+     * The paint belongs to this graph alone: painting an edge shared with a copy doesn't paint it on the copy.
      */
-    void paintEdge(Edge* v);
+    void paintEdge(const Edge* e);
 
     /*
-     * Return true if the edge is painted, false otherwise
+     * Return true if the edge is painted on this graph, false otherwise
      */
-    bool paintedEdge(Edge* v);
+    bool paintedEdge(const Edge* e) const;
 
     /*
      * Unpaint a painted edge
      */
-    void unpaintEdge(Edge* v);
+    void unpaintEdge(const Edge* e);
 
     /*
      * Get the .DOT format representation of the graph.
@@ -166,8 +331,10 @@ public:
     class AdjacentsIterator {
 
         public:
-            AdjacentsIterator(Graph::Node me, const std::vector<float>& conections, uint n, IMPL type);
-            AdjacentsIterator(Graph::Node me, const std::list<std::pair<uint,float> >& adjacents, uint n, IMPL type);
+            AdjacentsIterator(const Graph::Node& me, std::shared_ptr<const WeightsRow> conections, uint n, IMPL type);
+            AdjacentsIterator(std::shared_ptr<const WeightedAdjacents> adjacents, uint n, IMPL type);
+            AdjacentsIterator(std::shared_ptr<const BitsRow> bits, uint n);
+            AdjacentsIterator(std::shared_ptr<const Adjacents> adjacents, uint n);
 
             /*
              * Get current adjacent of the iterator. This not modify the iterator status.
@@ -187,64 +354,235 @@ public:
         private:
             uint _vSpace;
             IMPL _impl;
-            std::vector<float> _values;
-            std::list<std::pair<uint,float> > _adjacents;
-            std::vector<float>::const_iterator _it;
-            std::list<std::pair<uint,float> >::const_iterator _iter;
+            std::shared_ptr<const WeightsRow> _values;
+            std::shared_ptr<const WeightedAdjacents> _adjacents;
+            WeightedAdjacents::const_iterator _iter;
+            bool _weighted;
+            std::shared_ptr<const BitsRow> _bits;
+            std::shared_ptr<const Adjacents> _neighbors;
+            Adjacents::const_iterator _niter;
             int _current;
-            bool firstCall;
     };
 
-    class DFSIterator {
+    /*
+     * Depth first traversal of the graph from a node, allocating from the arena of the graph.
+     */
+    class DFSIterator : public DFSTraversal<Graph> {
 
         public:
-            DFSIterator(uint source, Graph* g);
+            DFSIterator(uint source, const Graph* g);
+    };
 
-            /*
-             * Get current node of the iterator. This not modify the iterator status.
-             */
-            uint next() const;
-            
-            void advance();
+    /*
+     * Breadth first traversal of the graph from a node, allocating from the arena of the graph.
+     */
+    class BFSIterator : public BFSTraversal<Graph> {
 
-            bool thereIsMore() const;
+        public:
+            BFSIterator(uint source, const Graph* g);
+    };
+
+private:
+    /*
+     * A value shared between copies of a graph, copied the first time one of them writes it.
+     */
+    template<class T>
+    class CopyOnWrite {
+
+        public:
+            CopyOnWrite(Arena* arena = NULL)
+                : _arena(arena), _value(std::allocate_shared<T>(ArenaAllocator<T>(arena), arena)) { }
+
+            // A moved value is null, and reads as an empty one until it is written again.
+            const T& operator*() const {
+                return _value ? *_value : _empty();
+            }
+
+            const T* operator->() const {
+                return &**this;
+            }
+
+            T& write() {
+                if(!_value)
+                    _value = std::allocate_shared<T>(ArenaAllocator<T>(_arena), _arena);
+                else if(_value.use_count() > 1)
+                    _value = std::allocate_shared<T>(ArenaAllocator<T>(_arena), *_value);
+
+                return *_value;
+            }
 
         private:
-            Graph* _g;
-            uint _source;
-            std::stack<uint> _q;
-            std::vector<bool> _visited_nodes;
+            Arena* _arena;
+            std::shared_ptr<T> _value;
+
+            static const T& _empty() {
+                static const T empty((Arena*) NULL);
+                return empty;
+            }
     };
 
-    class BFSIterator {
+    /*
+     * The rows of the graph, one per node. Copies of a graph share the sequence of rows and every row:
+     * writing a row copies the sequence of pointers (once, in O(n)) and that row alone (if it is shared).
+     * Iterators keep the row they walk alive, so they see the row as it was when they were created.
+     */
+    template<class Row>
+    class SharedRows {
 
         public:
-            BFSIterator(uint source, Graph* g);
+            SharedRows(Arena* arena = NULL) : _arena(arena), _rows(arena) { }
 
-            /*
-             * Get current node of the iterator. This not modify the iterator status.
-             */
-            uint next() const;
-            
-            void advance();
+            uint size() const {
+                return _rows->size();
+            }
 
-            bool thereIsMore() const;
+            const Row& operator[](uint i) const {
+                return *(*_rows)[i];
+            }
+
+            std::shared_ptr<const Row> share(uint i) const {
+                return (*_rows)[i];
+            }
+
+            Row& write(uint i) {
+                std::shared_ptr<Row>& row = _rows.write()[i];
+                if(row.use_count() > 1)
+                    row = std::allocate_shared<Row>(ArenaAllocator<Row>(_arena), *row);
+
+                return *row;
+            }
+
+            // Every row starts as the same shared prototype, it will be copied on its first write.
+            void assign(uint n, const Row& prototype) {
+                _rows.write().assign(n, std::allocate_shared<Row>(ArenaAllocator<Row>(_arena), prototype));
+            }
+
+            void push_back(const Row& row) {
+                _rows.write().push_back(std::allocate_shared<Row>(ArenaAllocator<Row>(_arena), row));
+            }
+
+            void push_back(Row&& row) {
+                _rows.write().push_back(std::allocate_shared<Row>(ArenaAllocator<Row>(_arena), std::move(row)));
+            }
 
         private:
-            Graph* _g;
-            uint _source;
-            std::queue<uint> _q;
-            std::vector<bool> _visited_nodes;
+            typedef std::vector<std::shared_ptr<Row>, ArenaAllocator<std::shared_ptr<Row> > > Pointers;
+
+            Arena* _arena;
+            CopyOnWrite<Pointers> _rows;
     };
 
-private:
-    std::vector<std::vector<float> > matrix;
-    std::vector<std::list<std::pair<uint,float> > > adjList;
-    std::vector<Graph::Node> nodes;
+    /*
+     * A segment of the edges of a graph, after the edges of the previous segments. A segment shared with copies
+     * or views of the graph is never written again: the graph adds its next edges on a new segment of its own.
+     */
+    struct EdgeSegment {
+        EdgeSegment(Arena* arena) : edges(arena), count(0) { }
+
+        EdgeList edges;
+        std::shared_ptr<EdgeSegment> previous;
+        uint count;
+    };
+
+    /*
+     * Topological order maintained on an oriented graph, with the predecessors of every node
+     * needed by the backward searches.
+     */
+    struct TopologicalOrder {
+        typedef std::vector<uint, ArenaAllocator<uint> > Indexes;
+        typedef std::vector<Indexes, ArenaAllocator<Indexes> > Predecessors;
+
+        TopologicalOrder(Arena* arena) : enabled(false), position(arena), order(arena), predecessors(arena) { }
+
+        bool enabled;
+        Indexes position;
+        Indexes order;
+        Predecessors predecessors;
+    };
+
+    SharedRows<WeightsRow> matrix;
+    SharedRows<WeightedAdjacents> adjList;
+    SharedRows<BitsRow> bitMatrix;
+    SharedRows<Adjacents> neighbors;
+    CopyOnWrite<NodesVector> nodes;
+    CopyOnWrite<TopologicalOrder> topo;
     bool isOriented;
+    bool isWeighted;
     IMPL type;
-    std::list<Graph::Edge> edges;
+    Arena* arena;
+    uint64_t version;
+    bool adaptive;
+    double denseThreshold;
+    double sparseThreshold;
+    ConversionReports conversions;
+
+    //The last segment of the edges, holding the count of all of them
+    std::shared_ptr<EdgeSegment> edgeSegments;
+
+    //A bit per painted edge, by the index of the edge
+    CopyOnWrite<BitsRow> paintedEdges;
+
+    void _addEdge(uint v1, uint v2, float weight);
+    uint _edgeIndex(const Edge* e, const char* function) const;
+    bool _forwardRegion(uint source, uint target, uint bound, std::vector<uint>& region) const;
+    void _orderEdge(uint v1, uint v2);
+    size_t _storageBytes(IMPL impl) const;
+    void _adapt();
+
+    template<class Row, class Fill>
+    void _rebuildRows(SharedRows<Row>& target, const Row& prototype, Fill fill);
+};
+
+/*
+ * The edges of a graph, read without modifying it: the segments shared with its copies and its own ones, in order.
+ * The view and its iterators keep the edges alive, and don't see the edges applied after the view was taken.
+ */
+class Graph::EdgesView {
+
+    struct Segments;
+
+    public:
+        class const_iterator {
+
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef Edge value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const Edge* pointer;
+                typedef const Edge& reference;
+
+                reference operator*() const;
+                pointer operator->() const;
+                const_iterator& operator++();
+                const_iterator operator++(int);
+                bool operator==(const const_iterator& other) const;
+                bool operator!=(const const_iterator& other) const;
+
+            private:
+                friend class EdgesView;
+
+                std::shared_ptr<const Segments> _segments;
+                size_t _list;
+                EdgeList::const_iterator _edge;
+
+                const_iterator(std::shared_ptr<const Segments> segments, size_t list);
+                void _skipEmpty();
+        };
+
+        const_iterator begin() const;
+        const_iterator end() const;
+        uint size() const;
+
+    private:
+        friend class Graph;
+
+        //The segments in order, kept alive by the view and its iterators
+        struct Segments {
+            std::shared_ptr<const EdgeSegment> last;
+            std::vector<const EdgeList*> lists;
+        };
 
+        std::shared_ptr<const Segments> _segments;
 };
 
 #endif
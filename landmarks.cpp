@@ -0,0 +1,314 @@
+#include "landmarks.h"
+#include "shortest_paths.h"
+#include <queue>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+    const uint NONE = (uint) -1;
+    const char MAGIC[4] = {'A', 'L', 'T', '1'};
+
+    template<class T>
+    void writeRaw(ofstream& out, const T* values, size_t count) {
+        out.write(reinterpret_cast<const char*>(values), count * sizeof(T));
+    }
+
+    template<class T>
+    void readRaw(ifstream& in, T* values, size_t count) {
+        in.read(reinterpret_cast<char*>(values), count * sizeof(T));
+    }
+
+}
+
+// Empty index over g, with the scratch of the queries and the reversed edges, but no landmarks yet.
+LandmarkIndex::LandmarkIndex(const Graph* graph) {
+    const Graph& g = *graph;
+    _g = graph;
+    _version = g.getVersion();
+    _n = g.getNodesCount();
+    _k = 0;
+    _query = 0;
+    _settled = 0;
+
+    for (uint side = 0; side < 2; ++side) {
+        _stamp[side] = vector<uint>(_n, 0);
+        _dist[side] = vector<float>(_n, DEFAULT_WEIGHT);
+        _parent[side] = vector<uint>(_n, NONE);
+    }
+    _potentialStamp = vector<uint>(_n, 0);
+    _potential = vector<float>(_n, 0);
+
+    if(g.isOrientedGraph()) {
+        _reversed = make_shared<Graph>(_n, true, ADJACENCIES_LIST, g.isWeightedGraph());
+        for (uint v = 0; v < _n; ++v)
+            for(auto it = g.adjacentsOf(v); it.thereIsMore(); it.advance())
+                _reversed->applyEdge(it.next().first, v, it.next().second);
+    }
+}
+
+LandmarkIndex::LandmarkIndex(const Graph& g, uint landmarks) : LandmarkIndex(&g) {
+    _k = min(landmarks, _n);
+    _from = vector<float>((size_t) _n * _k);
+    if(_reversed)
+        _to = vector<float>((size_t) _n * _k);
+
+    //How far every node is from the landmarks chosen so far, both ways on an oriented graph
+    vector<float> separation(_n, DEFAULT_WEIGHT);
+    uint next = 0;
+    if(_k > 0) {
+        SingleSourceShortestPaths start(g, 0);
+        for (uint v = 0; v < _n; ++v)
+            if(start.getDistance(v) > start.getDistance(next))
+                next = v;
+    }
+
+    for (uint i = 0; i < _k; ++i) {
+        uint landmark = next;
+        _landmarks.push_back(landmark);
+
+        SingleSourceShortestPaths forward(g, landmark);
+        for (uint v = 0; v < _n; ++v) {
+            _from[(size_t) v * _k + i] = forward.getDistance(v);
+            separation[v] = min(separation[v], forward.getDistance(v));
+        }
+
+        if(_reversed) {
+            SingleSourceShortestPaths backward(*_reversed, landmark);
+            for (uint v = 0; v < _n; ++v) {
+                _to[(size_t) v * _k + i] = backward.getDistance(v);
+                separation[v] = min(separation[v], backward.getDistance(v));
+            }
+        }
+
+        //The next landmark is the farthest node, an unreachable one if there is any
+        separation[landmark] = 0;
+        next = max_element(separation.begin(), separation.end()) - separation.begin();
+    }
+}
+
+void LandmarkIndex::save(const char* fileName) const {
+    ofstream out(fileName, ios::binary);
+    if(!out)
+        throw runtime_error("LandmarkIndex save: the file couldn't be opened.");
+
+    uint header[3] = {_n, _k, _reversed ? 1u : 0u};
+    out.write(MAGIC, sizeof(MAGIC));
+    writeRaw(out, header, 3);
+    writeRaw(out, _landmarks.data(), _landmarks.size());
+    writeRaw(out, _from.data(), _from.size());
+    writeRaw(out, _to.data(), _to.size());
+
+    if(!out)
+        throw runtime_error("LandmarkIndex save: write to the file failed.");
+}
+
+LandmarkIndex LandmarkIndex::load(const Graph& g, const char* fileName) {
+    ifstream in(fileName, ios::binary);
+    if(!in)
+        throw runtime_error("LandmarkIndex load: the file couldn't be opened.");
+
+    char magic[sizeof(MAGIC)];
+    uint header[3];
+    in.read(magic, sizeof(magic));
+    readRaw(in, header, 3);
+
+    if(!in || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw invalid_argument("Invalid argument on load member function, the file isn't a landmark index.");
+    if(header[0] != g.getNodesCount() || (header[2] == 1) != g.isOrientedGraph() || header[1] > header[0])
+        throw invalid_argument("Invalid argument on load member function, the index wasn't built for the graph.");
+
+    LandmarkIndex index(&g);
+    index._k = header[1];
+    index._landmarks = vector<uint>(index._k);
+    index._from = vector<float>((size_t) index._n * index._k);
+    if(index._reversed)
+        index._to = vector<float>((size_t) index._n * index._k);
+
+    readRaw(in, index._landmarks.data(), index._landmarks.size());
+    readRaw(in, index._from.data(), index._from.size());
+    readRaw(in, index._to.data(), index._to.size());
+
+    if(!in)
+        throw runtime_error("LandmarkIndex load: read from the file failed.");
+
+    return index;
+}
+
+const vector<uint>& LandmarkIndex::getLandmarks() const {
+    return _landmarks;
+}
+
+float LandmarkIndex::getDistance(uint from, uint to) {
+    _checkVersion("getDistance");
+    if(from >= _n || to >= _n)
+        throw invalid_argument("Invalid arguments on getDistance member function, from or to aren't nodes of the graph.");
+
+    uint meeting;
+    return _search(from, to, meeting);
+}
+
+vector<uint> LandmarkIndex::getPath(uint from, uint to) {
+    _checkVersion("getPath");
+    if(from >= _n || to >= _n)
+        throw invalid_argument("Invalid arguments on getPath member function, from or to aren't nodes of the graph.");
+
+    uint meeting;
+    vector<uint> path;
+    if(_search(from, to, meeting) == DEFAULT_WEIGHT)
+        return path;
+
+    //Forward half up to the meeting node, then the backward half down to the target
+    for (uint v = meeting; v != from; v = _parent[0][v])
+        path.push_back(v);
+    path.push_back(from);
+    reverse(path.begin(), path.end());
+
+    for (uint v = meeting; v != to; ) {
+        v = _parent[1][v];
+        path.push_back(v);
+    }
+
+    return path;
+}
+
+uint LandmarkIndex::getLastSettledCount() const {
+    return _settled;
+}
+
+size_t LandmarkIndex::getMemoryUsage() const {
+    size_t scratch = _n * (2 * (sizeof(uint) + sizeof(float) + sizeof(uint)) + sizeof(uint) + sizeof(float));
+    return sizeof(LandmarkIndex) + _landmarks.size() * sizeof(uint)
+         + (_from.size() + _to.size()) * sizeof(float) + scratch;
+}
+
+void LandmarkIndex::_checkVersion(const char* function) const {
+    if(_g->getVersion() != _version)
+        throw invalid_argument(string("Invalid argument on ") + function + " member function, the graph was modified after building the index.");
+}
+
+// Lower bound of the distance from v to t, DEFAULT_WEIGHT if some landmark proves that t isn't reachable from v.
+float LandmarkIndex::_lowerBound(uint v, uint t) const {
+    const float* fromV = _from.data() + (size_t) v * _k;
+    const float* fromT = _from.data() + (size_t) t * _k;
+    const float* toV = _to.empty() ? fromV : _to.data() + (size_t) v * _k;
+    const float* toT = _to.empty() ? fromT : _to.data() + (size_t) t * _k;
+
+    float bound = 0;
+    for (uint i = 0; i < _k; ++i) {
+        //d(L, t) <= d(L, v) + d(v, t)
+        if(fromV[i] != DEFAULT_WEIGHT) {
+            if(fromT[i] == DEFAULT_WEIGHT)
+                return DEFAULT_WEIGHT;
+            bound = max(bound, fromT[i] - fromV[i]);
+        }
+
+        //d(v, L) <= d(v, t) + d(t, L)
+        if(toT[i] != DEFAULT_WEIGHT) {
+            if(toV[i] == DEFAULT_WEIGHT)
+                return DEFAULT_WEIGHT;
+            bound = max(bound, toV[i] - toT[i]);
+        }
+    }
+
+    return bound;
+}
+
+// Average of the forward and backward potentials, so both searches see the same reduced weights.
+// DEFAULT_WEIGHT if v can't be on a path from s to t.
+float LandmarkIndex::_potentialOf(uint v, uint s, uint t) {
+    if(_potentialStamp[v] == _query)
+        return _potential[v];
+
+    float toTarget = _lowerBound(v, t), fromSource = _lowerBound(s, v);
+    _potentialStamp[v] = _query;
+    _potential[v] = toTarget == DEFAULT_WEIGHT || fromSource == DEFAULT_WEIGHT
+                  ? DEFAULT_WEIGHT : (toTarget - fromSource) / 2;
+
+    return _potential[v];
+}
+
+float LandmarkIndex::_search(uint s, uint t, uint& meeting) {
+    //Restart the stamps when they wrap around
+    if(++_query == 0) {
+        for (uint side = 0; side < 2; ++side)
+            fill(_stamp[side].begin(), _stamp[side].end(), 0);
+        fill(_potentialStamp.begin(), _potentialStamp.end(), 0);
+        _query = 1;
+    }
+
+    _settled = 0;
+    meeting = NONE;
+
+    uint ends[2] = {s, t};
+    for (uint side = 0; side < 2; ++side) {
+        _stamp[side][ends[side]] = _query;
+        _dist[side][ends[side]] = 0;
+        _parent[side][ends[side]] = ends[side];
+    }
+
+    if(s == t) {
+        meeting = s;
+        return 0;
+    }
+    if(_potentialOf(s, s, t) == DEFAULT_WEIGHT)
+        return DEFAULT_WEIGHT;
+
+    //The forward search keys are distance + potential, the backward ones distance - potential
+    typedef pair<float,uint> Pending;
+    priority_queue<Pending, vector<Pending>, greater<Pending> > pending[2];
+    pending[0].push(make_pair(_potentialOf(s, s, t), s));
+    pending[1].push(make_pair(-_potentialOf(t, s, t), t));
+
+    float best = DEFAULT_WEIGHT;
+
+    while(!pending[0].empty() && !pending[1].empty()) {
+        if(best != DEFAULT_WEIGHT && pending[0].top().first + pending[1].top().first >= best)
+            break;
+
+        uint side = pending[0].top().first <= pending[1].top().first ? 0 : 1;
+        Pending top = pending[side].top();
+        pending[side].pop();
+
+        uint v = top.second;
+        float sign = side == 0 ? 1 : -1;
+        if(top.first > _dist[side][v] + sign * _potentialOf(v, s, t))
+            continue;
+        _settled++;
+
+        const Graph& walk = side == 1 && _reversed ? *_reversed : *_g;
+        for(auto it = walk.adjacentsOf(v); it.thereIsMore(); it.advance()) {
+            uint w = it.next().first;
+            float weight = it.next().second;
+
+            if(weight < 0)
+                throw invalid_argument("Invalid argument on LandmarkIndex query, the graph has a negative weight.");
+
+            float potential = _potentialOf(w, s, t);
+            if(potential == DEFAULT_WEIGHT)
+                continue;
+
+            float d = _dist[side][v] + weight;
+            if(_stamp[side][w] == _query && d >= _dist[side][w])
+                continue;
+
+            _stamp[side][w] = _query;
+            _dist[side][w] = d;
+            _parent[side][w] = v;
+            pending[side].push(make_pair(d + sign * potential, w));
+
+            if(_stamp[1 - side][w] == _query && d + _dist[1 - side][w] < best) {
+                best = d + _dist[1 - side][w];
+                meeting = w;
+            }
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,96 @@
+#ifndef __LANDMARKS__H__
+#define __LANDMARKS__H__
+
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include "graph.h"
+
+/*
+ * A preprocessing index for point to point shortest path queries (ALT: A*, landmarks and triangle inequality).
+ * A few landmark nodes are chosen far from each other, and the distances between every node and every
+ * landmark are stored node by node on a contiguous array. For any node v and target t, the triangle inequality
+ * over a landmark L gives lower bounds of d(v, t) like d(L, t) - d(L, v) and d(v, L) - d(t, L). Queries run a
+ * bidirectional A* guided by those bounds, that settles far fewer nodes than a plain Dijkstra.
+ * Every weight must be non negative. The index is bound to the version of the graph it was built on:
+ * once the graph is modified, queries throw until the index is built again.
+ * Queries reuse scratch arrays of the index, so they aren't safe from several threads at once.
+ */
+class LandmarkIndex {
+
+public:
+    /*
+     * Build the index of g with the given count of landmarks. Each landmark is the node farthest from the
+     * ones already chosen, nodes on components without a landmark first. Costs a Dijkstra per landmark,
+     * two on an oriented graph.
+     */
+    LandmarkIndex(const Graph& g, uint landmarks = 8);
+
+    /*
+     * Write the index into a binary file, to load it later for the same graph.
+     */
+    void save(const char* fileName) const;
+
+    /*
+     * Read an index written by save, for the graph g. The graph must be the one the index was built on,
+     * only its count of nodes and orientation can be checked.
+     */
+    static LandmarkIndex load(const Graph& g, const char* fileName);
+
+    /*
+     * Return the landmark nodes.
+     */
+    const std::vector<uint>& getLandmarks() const;
+
+    /*
+     * Return the length of a shortest path from the node from to the node to, DEFAULT_WEIGHT if there is none.
+     */
+    float getDistance(uint from, uint to);
+
+    /*
+     * Return the nodes of a shortest path from the node from to the node to, both included, empty if there is none.
+     */
+    std::vector<uint> getPath(uint from, uint to);
+
+    /*
+     * Return the count of nodes settled by both searches of the last query.
+     */
+    uint getLastSettledCount() const;
+
+    /*
+     * Return the bytes taken by the index.
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    const Graph* _g;
+    uint64_t _version;
+    uint _n;
+    uint _k;
+    std::vector<uint> _landmarks;
+
+    //_from[v * k + i] is the distance from the landmark i to v, and _to[v * k + i] from v to the landmark i
+    std::vector<float> _from;
+    std::vector<float> _to;
+
+    //The backward search walks the reversed edges of an oriented graph
+    std::shared_ptr<Graph> _reversed;
+
+    //Scratch of the queries, valid on a node only if its stamp is the one of the current query
+    uint _query;
+    uint _settled;
+    std::vector<uint> _stamp[2];
+    std::vector<float> _dist[2];
+    std::vector<uint> _parent[2];
+    std::vector<uint> _potentialStamp;
+    std::vector<float> _potential;
+
+    LandmarkIndex(const Graph* g);
+
+    float _lowerBound(uint v, uint to) const;
+    float _potentialOf(uint v, uint from, uint to);
+    float _search(uint from, uint to, uint& meeting);
+    void _checkVersion(const char* function) const;
+};
+
+#endif
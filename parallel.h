@@ -0,0 +1,42 @@
+#ifndef __PARALLEL__H__
+#define __PARALLEL__H__
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+/*
+ * Call f(i) for every i between begin (inclusive) and end (exclusive), splitting the range in
+ * contiguous chunks of at least minChunk indexes among the available hardware threads.
+ * Runs on the calling thread when the range is too small to be worth splitting.
+ */
+template<class F>
+void parallelFor(unsigned int begin, unsigned int end, F f, unsigned int minChunk = 256) {
+    if(end <= begin) return;
+
+    unsigned int hardware = std::max(std::thread::hardware_concurrency(), 1u);
+    unsigned int workers = std::min(hardware, (end - begin + minChunk - 1) / std::max(minChunk, 1u));
+
+    if(workers <= 1) {
+        for (unsigned int i = begin; i < end; ++i)
+            f(i);
+        return;
+    }
+
+    unsigned int chunk = (end - begin + workers - 1) / workers;
+    std::vector<std::thread> threads;
+    for (unsigned int w = 0; w < workers; ++w) {
+        unsigned int from = begin + w * chunk, to = std::min(end, from + chunk);
+        if(from >= to) break;
+
+        threads.push_back(std::thread([from, to, &f]() {
+            for (unsigned int i = from; i < to; ++i)
+                f(i);
+        }));
+    }
+
+    for (auto& t : threads)
+        t.join();
+}
+
+#endif
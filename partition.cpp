@@ -0,0 +1,475 @@
+#include "partition.h"
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <stdexcept>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+const uint PartitionedGraph::UNREACHED = numeric_limits<uint>::max();
+
+namespace {
+
+    uint hashNode(uint v) {
+        v ^= v >> 16;
+        v *= 0x45d9f3b;
+        v ^= v >> 16;
+        return v;
+    }
+
+    /*
+     * Streaming greedy assignment shared by LDG and Fennel. Each node is placed on the shard
+     * maximizing (neighbors already on the shard) - penalty(shard size), never over capacity.
+     */
+    vector<uint> greedyAssignment(const Graph& g, uint k, PARTITION_STRATEGY strategy) {
+        uint n = g.getNodesCount();
+        vector<uint> owners(n, k);
+        vector<uint> sizes(k, 0);
+        vector<uint> neighborsOn(k, 0);
+
+        double capacity = ceil((double) n / k);
+        double gamma = 1.5;
+        double alpha = sqrt((double) k) * max(g.getEdgesCount(), 1u) / pow((double) max(n, 1u), gamma);
+        if(strategy == FENNEL_PARTITION)
+            capacity = ceil(1.1 * n / k);
+
+        for (uint v = 0; v < n; ++v) {
+            fill(neighborsOn.begin(), neighborsOn.end(), 0);
+            for(auto it = g.adjacentsOf(v); it.thereIsMore(); it.advance())
+                if(owners[it.next().first] < k)
+                    neighborsOn[owners[it.next().first]]++;
+
+            uint best = k;
+            double bestScore = 0;
+            for (uint i = 0; i < k; ++i) {
+                if(sizes[i] >= capacity) continue;
+
+                double score;
+                if(strategy == LDG_PARTITION)
+                    score = neighborsOn[i] * (1.0 - sizes[i] / capacity);
+                else
+                    score = neighborsOn[i] - alpha * gamma * pow((double) sizes[i], gamma - 1);
+
+                if(best == k || score > bestScore || (score == bestScore && sizes[i] < sizes[best])) {
+                    best = i;
+                    bestScore = score;
+                }
+            }
+
+            owners[v] = best;
+            sizes[best]++;
+        }
+
+        return owners;
+    }
+
+    /*
+     * Per-shard state of the BSP BFS. Levels are kept only for the owned nodes.
+     */
+    struct BSPWorker {
+        const PartitionedGraph& pg;
+        const PartitionedGraph::Shard& shard;
+        vector<uint> levels;
+        vector<uint> frontier;
+        vector<uint> nextFrontier;
+        uint depth;
+
+        BSPWorker(const PartitionedGraph& p, uint id)
+            : pg(p), shard(p.getShard(id)), levels(shard.getOwnedCount(), PartitionedGraph::UNREACHED), depth(0) { }
+
+        void seed(uint source) {
+            int local = shard.toLocal(source);
+            levels[local] = 0;
+            frontier.push_back(local);
+        }
+
+        // Expands the frontier, filling outbox[j] with the ghost nodes owned by shard j.
+        void expand(vector<vector<uint> >& outbox) {
+            const Graph& g = shard.getGraph();
+
+            for (uint v : frontier) {
+                for(auto it = g.adjacentsOf(v); it.thereIsMore(); it.advance()) {
+                    uint w = it.next().first;
+
+                    if(shard.isGhost(w)) {
+                        uint global = shard.toGlobal(w);
+                        outbox[pg.ownerOf(global)].push_back(global);
+                    } else if(levels[w] == PartitionedGraph::UNREACHED) {
+                        levels[w] = depth + 1;
+                        nextFrontier.push_back(w);
+                    }
+                }
+            }
+        }
+
+        // Applies the nodes discovered by other shards and closes the superstep.
+        uint receive(const vector<uint>& inbox) {
+            for (uint global : inbox) {
+                uint w = shard.toLocal(global);
+                if(levels[w] == PartitionedGraph::UNREACHED) {
+                    levels[w] = depth + 1;
+                    nextFrontier.push_back(w);
+                }
+            }
+
+            frontier.swap(nextFrontier);
+            nextFrontier.clear();
+            depth++;
+
+            return frontier.size();
+        }
+    };
+
+    // send with MSG_NOSIGNAL: a dead peer fails the write instead of killing the process with SIGPIPE.
+    void writeAll(int fd, const void* data, size_t bytes) {
+        const char* p = (const char*) data;
+        while(bytes > 0) {
+            ssize_t w = send(fd, p, bytes, MSG_NOSIGNAL);
+            if(w < 0 && errno == EINTR)
+                continue;
+            if(w <= 0)
+                throw runtime_error("BFS multiprocess: write to shard socket failed.");
+            p += w;
+            bytes -= w;
+        }
+    }
+
+    void readAll(int fd, void* data, size_t bytes) {
+        char* p = (char*) data;
+        while(bytes > 0) {
+            ssize_t r = read(fd, p, bytes);
+            if(r < 0 && errno == EINTR)
+                continue;
+            if(r <= 0)
+                throw runtime_error("BFS multiprocess: read from shard socket failed.");
+            p += r;
+            bytes -= r;
+        }
+    }
+
+    /*
+     * The shard processes of a multiprocess BFS and the coordinator ends of their sockets. The destructor
+     * closes every socket and waits for every process, killing them first unless the BFS finished: on an
+     * error path no process is left blocked on a socket, and no descriptor leaks.
+     */
+    struct ShardProcesses {
+        vector<int> sockets;
+        vector<pid_t> children;
+        bool finished;
+
+        ShardProcesses() : finished(false) { }
+
+        ~ShardProcesses() {
+            for (int fd : sockets)
+                close(fd);
+
+            for (pid_t pid : children) {
+                if(!finished)
+                    kill(pid, SIGKILL);
+                while(waitpid(pid, NULL, 0) < 0 && errno == EINTR) { }
+            }
+        }
+    };
+
+    void sendVector(int fd, const vector<uint>& v) {
+        uint size = v.size();
+        writeAll(fd, &size, sizeof(uint));
+        if(size > 0)
+            writeAll(fd, v.data(), size * sizeof(uint));
+    }
+
+    vector<uint> receiveVector(int fd) {
+        uint size;
+        readAll(fd, &size, sizeof(uint));
+        vector<uint> v(size);
+        if(size > 0)
+            readAll(fd, v.data(), size * sizeof(uint));
+        return v;
+    }
+
+    /*
+     * Body of a shard process: one expand/receive round per superstep, driven by the coordinator.
+     */
+    void runShardProcess(int fd, const PartitionedGraph& pg, uint id, uint source) {
+        uint k = pg.getShardsCount();
+        BSPWorker worker(pg, id);
+        if(pg.ownerOf(source) == id)
+            worker.seed(source);
+
+        uint proceed = 1;
+        while(proceed) {
+            vector<vector<uint> > outbox(k);
+            worker.expand(outbox);
+            for (uint j = 0; j < k; ++j)
+                sendVector(fd, outbox[j]);
+
+            uint pending = worker.receive(receiveVector(fd));
+            writeAll(fd, &pending, sizeof(uint));
+            readAll(fd, &proceed, sizeof(uint));
+        }
+
+        sendVector(fd, worker.levels);
+    }
+
+}
+
+
+/*
+ * Shard implementation.
+ */
+
+PartitionedGraph::Shard::Shard(uint id, const vector<uint>& owned, const Graph& g, const vector<uint>& owners) {
+    _id = id;
+    _owned = owned.size();
+    _globals = owned;
+
+    for (uint i = 0; i < _owned; ++i)
+        _locals[owned[i]] = i;
+
+    //Collect the edges leaving owned nodes, adding a ghost for every remote end
+    vector<pair<pair<uint,uint>,float> > localEdges;
+    for (uint i = 0; i < _owned; ++i) {
+        uint loops = 0;
+        for(auto it = g.adjacentsOf(owned[i]); it.thereIsMore(); it.advance()) {
+            uint w = it.next().first;
+            bool remote = owners[w] != id;
+
+            //A non-oriented edge between two owned nodes is seen from both ends, keep it once
+            if(!remote && !g.isOrientedGraph() && w < owned[i])
+                continue;
+
+            //And so is a non-oriented self loop of a list graph, listed twice on its node
+            if(!g.isOrientedGraph() && w == owned[i] && g.getImplementation() == ADJACENCIES_LIST && loops++ % 2 == 1)
+                continue;
+
+            if(_locals.find(w) == _locals.end()) {
+                _locals[w] = _globals.size();
+                _globals.push_back(w);
+            }
+
+            localEdges.push_back(make_pair(make_pair(i, _locals[w]), it.next().second));
+        }
+    }
+
+    _local = Graph(_globals.size(), g.isOrientedGraph(), ADJACENCIES_LIST, g.isWeightedGraph());
+    for (const auto& e : localEdges)
+        _local.applyEdge(e.first.first, e.first.second, e.second);
+}
+
+uint PartitionedGraph::Shard::getId() const {
+    return _id;
+}
+
+uint PartitionedGraph::Shard::getOwnedCount() const {
+    return _owned;
+}
+
+uint PartitionedGraph::Shard::getGhostsCount() const {
+    return _globals.size() - _owned;
+}
+
+bool PartitionedGraph::Shard::isGhost(uint v) const {
+    if(v >= _globals.size())
+        throw invalid_argument("Invalid argument on isGhost member function, v isn't a node of the shard.");
+
+    return v >= _owned;
+}
+
+uint PartitionedGraph::Shard::toGlobal(uint v) const {
+    if(v >= _globals.size())
+        throw invalid_argument("Invalid argument on toGlobal member function, v isn't a node of the shard.");
+
+    return _globals[v];
+}
+
+int PartitionedGraph::Shard::toLocal(uint v) const {
+    auto it = _locals.find(v);
+    return it == _locals.end() ? -1 : (int) it->second;
+}
+
+const Graph& PartitionedGraph::Shard::getGraph() const {
+    return _local;
+}
+
+
+
+/*
+ * PartitionedGraph implementation.
+ */
+
+PartitionedGraph::PartitionedGraph(const Graph& g, uint shards, PARTITION_STRATEGY strategy) {
+    if(shards == 0)
+        throw invalid_argument("Invalid argument on PartitionedGraph constructor, shards count must be positive.");
+
+    uint n = g.getNodesCount();
+
+    if(strategy == HASH_PARTITION) {
+        _owners = vector<uint>(n);
+        for (uint v = 0; v < n; ++v)
+            _owners[v] = hashNode(v) % shards;
+
+    } else if(strategy == RANGE_PARTITION) {
+        _owners = vector<uint>(n);
+        for (uint v = 0; v < n; ++v)
+            _owners[v] = (uint) ((unsigned long long) v * shards / n);
+
+    } else {
+        _owners = greedyAssignment(g, shards, strategy);
+    }
+
+    vector<vector<uint> > owned(shards);
+    for (uint v = 0; v < n; ++v)
+        owned[_owners[v]].push_back(v);
+
+    for (uint i = 0; i < shards; ++i)
+        _shards.push_back(Shard(i, owned[i], g, _owners));
+
+    _edgeCut = 0;
+    for (uint v = 0; v < n; ++v)
+        for(auto it = g.adjacentsOf(v); it.thereIsMore(); it.advance())
+            if(_owners[v] != _owners[it.next().first] && (g.isOrientedGraph() || v < it.next().first))
+                _edgeCut++;
+}
+
+uint PartitionedGraph::getShardsCount() const {
+    return _shards.size();
+}
+
+uint PartitionedGraph::getNodesCount() const {
+    return _owners.size();
+}
+
+const PartitionedGraph::Shard& PartitionedGraph::getShard(uint i) const {
+    if(i >= _shards.size())
+        throw invalid_argument("Invalid argument on getShard member function, i isn't a shard of the partition.");
+
+    return _shards[i];
+}
+
+uint PartitionedGraph::ownerOf(uint v) const {
+    if(v >= _owners.size())
+        throw invalid_argument("Invalid argument on ownerOf member function, v isn't a node of the graph.");
+
+    return _owners[v];
+}
+
+uint PartitionedGraph::getEdgeCut() const {
+    return _edgeCut;
+}
+
+vector<uint> PartitionedGraph::BFS(uint source, bool multiprocess) const {
+    if(source >= _owners.size())
+        throw invalid_argument("Invalid argument on BFS member function, source isn't a node of the graph.");
+
+    return multiprocess ? _multiprocessBFS(source) : _localBFS(source);
+}
+
+vector<uint> PartitionedGraph::_localBFS(uint source) const {
+    uint k = _shards.size();
+    vector<BSPWorker> workers;
+    for (uint i = 0; i < k; ++i)
+        workers.push_back(BSPWorker(*this, i));
+
+    workers[_owners[source]].seed(source);
+
+    uint pending = 1;
+    while(pending > 0) {
+        vector<vector<uint> > inbox(k);
+        for (uint i = 0; i < k; ++i) {
+            vector<vector<uint> > outbox(k);
+            workers[i].expand(outbox);
+
+            for (uint j = 0; j < k; ++j)
+                inbox[j].insert(inbox[j].end(), outbox[j].begin(), outbox[j].end());
+        }
+
+        //Barrier: every shard has finished the superstep, deliver the messages
+        pending = 0;
+        for (uint j = 0; j < k; ++j)
+            pending += workers[j].receive(inbox[j]);
+    }
+
+    vector<uint> levels(_owners.size(), UNREACHED);
+    for (uint i = 0; i < k; ++i)
+        for (uint v = 0; v < _shards[i].getOwnedCount(); ++v)
+            levels[_shards[i].toGlobal(v)] = workers[i].levels[v];
+
+    return levels;
+}
+
+vector<uint> PartitionedGraph::_multiprocessBFS(uint source) const {
+    uint k = _shards.size();
+    ShardProcesses shards;
+    vector<int>& sockets = shards.sockets;
+
+    for (uint i = 0; i < k; ++i) {
+        int fds[2];
+        if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+            throw runtime_error("BFS multiprocess: socketpair failed.");
+        sockets.push_back(fds[0]);
+
+        pid_t pid = fork();
+        if(pid < 0) {
+            close(fds[1]);
+            throw runtime_error("BFS multiprocess: fork failed.");
+        }
+
+        if(pid == 0) {
+            for (int fd : sockets)
+                close(fd);
+
+            int status = 0;
+            try {
+                runShardProcess(fds[1], *this, i, source);
+            } catch (...) {
+                status = 1;
+            }
+            _exit(status);
+        }
+
+        close(fds[1]);
+        shards.children.push_back(pid);
+    }
+
+    //Coordinator: route the messages of each superstep and decide when to stop
+    vector<uint> levels(_owners.size(), UNREACHED);
+    uint proceed = 1;
+    while(proceed) {
+        vector<vector<uint> > inbox(k);
+        for (uint i = 0; i < k; ++i) {
+            for (uint j = 0; j < k; ++j) {
+                vector<uint> msg = receiveVector(sockets[i]);
+                inbox[j].insert(inbox[j].end(), msg.begin(), msg.end());
+            }
+        }
+
+        for (uint j = 0; j < k; ++j)
+            sendVector(sockets[j], inbox[j]);
+
+        uint pending = 0;
+        for (uint j = 0; j < k; ++j) {
+            uint p;
+            readAll(sockets[j], &p, sizeof(uint));
+            pending += p;
+        }
+
+        proceed = pending > 0;
+        for (uint j = 0; j < k; ++j)
+            writeAll(sockets[j], &proceed, sizeof(uint));
+    }
+
+    for (uint i = 0; i < k; ++i) {
+        vector<uint> owned = receiveVector(sockets[i]);
+        for (uint v = 0; v < owned.size(); ++v)
+            levels[_shards[i].toGlobal(v)] = owned[v];
+    }
+
+    //Every process sent its levels and is exiting, the destructor just waits for them
+    shards.finished = true;
+    return levels;
+}
@@ -0,0 +1,128 @@
+#ifndef __PARTITION__H__
+#define __PARTITION__H__
+
+#include <vector>
+#include <unordered_map>
+#include "graph.h"
+
+enum PARTITION_STRATEGY {HASH_PARTITION, RANGE_PARTITION, LDG_PARTITION, FENNEL_PARTITION};
+
+/*
+ * A graph split into shards, each one holding a subset of the nodes (the owned nodes) plus
+ * ghost/halo copies of the remote nodes adjacent to them.
+ * Every shard keeps its own local Graph, so each shard can be shipped to a different process.
+ */
+class PartitionedGraph {
+
+public:
+    /*
+     * Level assigned by BFS to the nodes not reachable from the source.
+     */
+    static const uint UNREACHED;
+
+    class Shard {
+
+        public:
+            Shard(uint id, const std::vector<uint>& owned, const Graph& g, const std::vector<uint>& owners);
+
+            /*
+             * Get the number of this shard, between 0 and shards count - 1.
+             */
+            uint getId() const;
+
+            /*
+             * Local nodes between 0 and getOwnedCount() - 1 (inclusive) are owned by this shard.
+             */
+            uint getOwnedCount() const;
+
+            /*
+             * Local nodes between getOwnedCount() and getOwnedCount() + getGhostsCount() - 1 (inclusive)
+             * are ghost copies of nodes owned by another shard.
+             */
+            uint getGhostsCount() const;
+
+            /*
+             * Return true if the local node v is a ghost node.
+             */
+            bool isGhost(uint v) const;
+
+            /*
+             * Translate a local node of this shard to its number on the original graph.
+             */
+            uint toGlobal(uint v) const;
+
+            /*
+             * Translate a node of the original graph to its local number on this shard.
+             * Returns -1 if the node is neither owned nor a ghost of this shard.
+             */
+            int toLocal(uint v) const;
+
+            /*
+             * Return the local graph of the shard, with every edge leaving an owned node.
+             * Ghost nodes have no edges of their own beside the ones connecting them with owned nodes.
+             */
+            const Graph& getGraph() const;
+
+        private:
+            uint _id;
+            uint _owned;
+            std::vector<uint> _globals;
+            std::unordered_map<uint,uint> _locals;
+            Graph _local;
+    };
+
+    /*
+     * Split the graph g into the given count of shards, following the selected strategy:
+       - HASH_PARTITION: each node goes to a shard chosen by a hash of its number.
+       - RANGE_PARTITION: contiguous ranges of nodes of the same size go to each shard.
+       - LDG_PARTITION: streaming Linear Deterministic Greedy, places each node where most of its neighbors are.
+       - FENNEL_PARTITION: streaming Fennel, like LDG but with a softer balance penalty.
+     * The greedy strategies try to minimize the count of edges crossing between shards.
+     */
+    PartitionedGraph(const Graph& g, uint shards, PARTITION_STRATEGY strategy = HASH_PARTITION);
+
+    /*
+     * Get the count of shards of the partition.
+     */
+    uint getShardsCount() const;
+
+    /*
+     * Get the count of nodes of the original graph.
+     */
+    uint getNodesCount() const;
+
+    /*
+     * Return the shard number i.
+     */
+    const Shard& getShard(uint i) const;
+
+    /*
+     * Return the number of the shard owning the node v of the original graph.
+     */
+    uint ownerOf(uint v) const;
+
+    /*
+     * Get the count of edges whose ends are owned by different shards.
+     */
+    uint getEdgeCut() const;
+
+    /*
+     * Run a BSP (bulk synchronous parallel) BFS from the source node across all the shards.
+     * On each superstep every shard expands its local frontier and sends the discovered ghost nodes
+     * to their owners. If multiprocess is true each shard runs in its own forked process, exchanging
+     * the messages through local sockets; otherwise the shards run one after another in this process.
+     * Returns the BFS level of each node of the original graph, UNREACHED for the non reachable ones.
+     * If a shard process fails, the others are killed and reaped before a runtime_error is thrown.
+     */
+    std::vector<uint> BFS(uint source, bool multiprocess = false) const;
+
+private:
+    std::vector<uint> _owners;
+    std::vector<Shard> _shards;
+    uint _edgeCut;
+
+    std::vector<uint> _localBFS(uint source) const;
+    std::vector<uint> _multiprocessBFS(uint source) const;
+};
+
+#endif
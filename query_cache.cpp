@@ -0,0 +1,126 @@
+#include "query_cache.h"
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+QueryCache::QueryCache(const Graph& g, size_t maxBytes) {
+    _g = &g;
+    _maxBytes = maxBytes;
+    _bytes = 0;
+    _hits = 0;
+    _misses = 0;
+}
+
+const vector<uint>& QueryCache::BFS(uint source) {
+    if(source >= _g->getNodesCount())
+        throw invalid_argument("Invalid argument on BFS member function, source isn't a node of the graph.");
+
+    return _lookup(BFS_QUERY, source).order;
+}
+
+bool QueryCache::isReachable(uint source, uint target) {
+    if(source >= _g->getNodesCount() || target >= _g->getNodesCount())
+        throw invalid_argument("Invalid arguments on isReachable member function, source or target aren't nodes of the graph.");
+
+    return _lookup(BFS_QUERY, source).reached[target];
+}
+
+float QueryCache::getDistance(uint source, uint target) {
+    if(source >= _g->getNodesCount() || target >= _g->getNodesCount())
+        throw invalid_argument("Invalid arguments on getDistance member function, source or target aren't nodes of the graph.");
+
+    return _lookup(SHORTEST_PATHS_QUERY, source).paths->getDistance(target);
+}
+
+vector<uint> QueryCache::getPath(uint source, uint target) {
+    if(source >= _g->getNodesCount() || target >= _g->getNodesCount())
+        throw invalid_argument("Invalid arguments on getPath member function, source or target aren't nodes of the graph.");
+
+    return _lookup(SHORTEST_PATHS_QUERY, source).paths->getPath(target);
+}
+
+uint64_t QueryCache::getHits() const {
+    return _hits;
+}
+
+uint64_t QueryCache::getMisses() const {
+    return _misses;
+}
+
+double QueryCache::getHitRate() const {
+    if(_hits + _misses == 0)
+        return 0;
+
+    return (double) _hits / (_hits + _misses);
+}
+
+uint QueryCache::getEntriesCount() const {
+    return _entries.size();
+}
+
+size_t QueryCache::getMemoryUsage() const {
+    return _bytes;
+}
+
+void QueryCache::clear() {
+    _entries.clear();
+    _index.clear();
+    _bytes = 0;
+}
+
+QueryCache::Entry& QueryCache::_lookup(Query query, uint source) {
+    uint64_t key = ((uint64_t) query << 32) | source;
+    auto found = _index.find(key);
+
+    if(found != _index.end()) {
+        if(found->second->version == _g->getVersion()) {
+            _hits++;
+            _entries.splice(_entries.begin(), _entries, found->second);
+            return _entries.front();
+        }
+
+        //Computed on an older version of the graph, it can't be used anymore
+        _bytes -= found->second->bytes;
+        _entries.erase(found->second);
+        _index.erase(found);
+    }
+
+    //Compute apart, so a failed query leaves the cache untouched
+    Entry entry;
+    entry.key = key;
+    entry.version = _g->getVersion();
+    _compute(query, source, entry);
+
+    _misses++;
+    _entries.push_front(std::move(entry));
+    _index[key] = _entries.begin();
+    _bytes += _entries.front().bytes;
+
+    //Evict the least recently used results, never the new one
+    while(_bytes > _maxBytes && _entries.size() > 1) {
+        _bytes -= _entries.back().bytes;
+        _index.erase(_entries.back().key);
+        _entries.pop_back();
+    }
+
+    return _entries.front();
+}
+
+void QueryCache::_compute(Query query, uint source, Entry& entry) const {
+    if(query == BFS_QUERY) {
+        entry.reached.assign(_g->getNodesCount(), false);
+        for (Graph::BFSIterator it(source, _g); it.thereIsMore(); it.advance()) {
+            entry.order.push_back(it.next());
+            entry.reached[it.next()] = true;
+        }
+    } else {
+        entry.paths = make_shared<SingleSourceShortestPaths>(*_g, source);
+    }
+
+    //The entry, its list and index nodes, and the results it holds
+    entry.bytes = sizeof(Entry) + 4 * sizeof(void*) + sizeof(uint64_t)
+                + entry.order.capacity() * sizeof(uint)
+                + entry.reached.capacity() / 8
+                + (entry.paths ? entry.paths->getMemoryUsage() : 0);
+}
@@ -0,0 +1,99 @@
+#ifndef __QUERY_CACHE__H__
+#define __QUERY_CACHE__H__
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <memory>
+#include "graph.h"
+#include "shortest_paths.h"
+
+/*
+ * A cache of the results of traversal and path queries over a Graph, for workloads repeating the same
+ * queries between modifications of the graph.
+ * Results are kept by (query, source, version of the graph): a result computed on an older version of the
+ * graph is never returned, it is dropped and computed again. A repeated query on an unchanged graph is answered
+ * without reading the adjacencies at all.
+ * The cache holds at most maxBytes of results, evicting the least recently used ones first; the result of
+ * the last query is always kept, even if it is bigger than maxBytes alone.
+ * The graph must outlive the cache. The cache isn't safe to use from several threads at once.
+ */
+class QueryCache {
+
+public:
+    /*
+     * Construct an empty cache over g, that will keep at most maxBytes of results.
+     */
+    QueryCache(const Graph& g, size_t maxBytes = 64 << 20);
+
+    /*
+     * Return the nodes reachable from source, in the order of a Graph::BFSIterator from it.
+     * The reference is valid until the next query to the cache.
+     */
+    const std::vector<uint>& BFS(uint source);
+
+    /*
+     * Return true if target is reachable from source. Shares the result of BFS(source).
+     */
+    bool isReachable(uint source, uint target);
+
+    /*
+     * Return the length of a shortest path from source to target, DEFAULT_WEIGHT if there is none.
+     * Every weight of the graph must be non negative.
+     */
+    float getDistance(uint source, uint target);
+
+    /*
+     * Return the nodes of a shortest path from source to target, both included, empty if there is none.
+     * Shares the result of getDistance(source, ...).
+     */
+    std::vector<uint> getPath(uint source, uint target);
+
+    /*
+     * Counters of the queries answered from the cache (hits) and computed on the graph (misses).
+     */
+    uint64_t getHits() const;
+    uint64_t getMisses() const;
+
+    /*
+     * Return the fraction of the queries answered from the cache, 0 before the first query.
+     */
+    double getHitRate() const;
+
+    /*
+     * Return the count of results kept and the bytes they take.
+     */
+    uint getEntriesCount() const;
+    size_t getMemoryUsage() const;
+
+    /*
+     * Drop every result kept. The counters are kept.
+     */
+    void clear();
+
+private:
+    enum Query {BFS_QUERY, SHORTEST_PATHS_QUERY};
+
+    struct Entry {
+        uint64_t key;
+        uint64_t version;
+        size_t bytes;
+        std::vector<uint> order;
+        std::vector<bool> reached;
+        std::shared_ptr<const SingleSourceShortestPaths> paths;
+    };
+
+    const Graph* _g;
+    size_t _maxBytes;
+    size_t _bytes;
+    uint64_t _hits;
+    uint64_t _misses;
+    std::list<Entry> _entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> _index;
+
+    Entry& _lookup(Query query, uint source);
+    void _compute(Query query, uint source, Entry& entry) const;
+};
+
+#endif
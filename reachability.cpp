@@ -0,0 +1,344 @@
+#include "reachability.h"
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+    const uint NONE = (uint) -1;
+
+}
+
+ReachabilityIndex::ReachabilityIndex(Graph& g, uint labels, uint maxPending) {
+    if(labels == 0)
+        throw invalid_argument("Invalid argument on ReachabilityIndex constructor, labels must be one at least.");
+
+    _g = &g;
+    _k = labels;
+    _maxPending = maxPending;
+    _fallbacks = 0;
+    _build();
+}
+
+bool ReachabilityIndex::isReachable(uint from, uint to) {
+    _refresh();
+    if(from >= _n || to >= _n)
+        throw invalid_argument("Invalid arguments on isReachable member function, from or to aren't nodes of the graph.");
+
+    return _reachable(_component[from], _component[to]);
+}
+
+void ReachabilityIndex::applyEdge(uint v1, uint v2, float weight) {
+    _refresh();
+    _g->applyEdge(v1, v2, weight);
+    _version = _g->getVersion();
+
+    //An edge between components already reaching each other changes nothing
+    uint c1 = _component[v1], c2 = _component[v2];
+    if(!_reachable(c1, c2))
+        _pending.push_back(make_pair(c1, c2));
+    if(!_g->isOrientedGraph() && !_reachable(c2, c1))
+        _pending.push_back(make_pair(c2, c1));
+
+    if(_pending.size() > _maxPending)
+        _build();
+}
+
+void ReachabilityIndex::rebuild() {
+    _build();
+}
+
+uint ReachabilityIndex::getComponentsCount() const {
+    return _tree.size();
+}
+
+uint ReachabilityIndex::getComponent(uint v) const {
+    if(v >= _n)
+        throw invalid_argument("Invalid argument on getComponent member function, v isn't a node of the graph.");
+
+    return _component[v];
+}
+
+uint ReachabilityIndex::getPendingEdgesCount() const {
+    return _pending.size();
+}
+
+uint64_t ReachabilityIndex::getFallbacksCount() const {
+    return _fallbacks;
+}
+
+size_t ReachabilityIndex::getMemoryUsage() const {
+    return sizeof(ReachabilityIndex)
+         + (_component.capacity() + _offsets.capacity() + _successors.capacity()) * sizeof(uint)
+         + (_tree.capacity() + _labels.capacity()) * sizeof(Interval)
+         + _pending.capacity() * sizeof(pair<uint,uint>)
+         + (_stamp.capacity() + _stack.capacity()) * sizeof(uint);
+}
+
+void ReachabilityIndex::_build() {
+    _version = _g->getVersion();
+    _n = _g->getNodesCount();
+    _pending.clear();
+
+    _condense();
+
+    uint components = _offsets.size() - 1;
+    _tree.assign(components, Interval());
+    _labels.assign((size_t) components * _k, Interval());
+    _stamp.assign(components, 0);
+    _search = 0;
+
+    for (uint i = 0; i < _k; ++i)
+        _label(i, i);
+}
+
+// Tarjan's strongly connected components over a copy of the adjacencies, then the DAG of the components.
+// Tarjan completes a component only after every component reachable from it, so edges go to lower numbers.
+void ReachabilityIndex::_condense() {
+    vector<uint> offsets(_n + 1), targets;
+    for (uint v = 0; v < _n; ++v) {
+        offsets[v] = targets.size();
+        for(auto it = _g->adjacentsOf(v); it.thereIsMore(); it.advance())
+            targets.push_back(it.next().first);
+    }
+    offsets[_n] = targets.size();
+
+    vector<uint> index(_n, NONE), low(_n), stack;
+    vector<bool> onStack(_n, false);
+    vector<pair<uint,uint> > calls;
+    uint counter = 0, components = 0;
+    _component.assign(_n, NONE);
+
+    for (uint root = 0; root < _n; ++root) {
+        if(index[root] != NONE)
+            continue;
+
+        index[root] = low[root] = counter++;
+        stack.push_back(root);
+        onStack[root] = true;
+        calls.push_back(make_pair(root, offsets[root]));
+
+        while(!calls.empty()) {
+            uint v = calls.back().first;
+
+            if(calls.back().second < offsets[v + 1]) {
+                uint w = targets[calls.back().second++];
+
+                if(index[w] == NONE) {
+                    index[w] = low[w] = counter++;
+                    stack.push_back(w);
+                    onStack[w] = true;
+                    calls.push_back(make_pair(w, offsets[w]));
+                } else if(onStack[w]) {
+                    low[v] = min(low[v], index[w]);
+                }
+                continue;
+            }
+
+            calls.pop_back();
+            if(!calls.empty())
+                low[calls.back().first] = min(low[calls.back().first], low[v]);
+
+            if(low[v] == index[v]) {
+                uint w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = false;
+                    _component[w] = components;
+                } while(w != v);
+                components++;
+            }
+        }
+    }
+
+    //Group the nodes by component, to gather the distinct successors of each component at once
+    vector<uint> first(components + 1, 0), members(_n);
+    for (uint v = 0; v < _n; ++v)
+        first[_component[v] + 1]++;
+    for (uint c = 0; c < components; ++c)
+        first[c + 1] += first[c];
+    for (uint v = 0; v < _n; ++v)
+        members[first[_component[v]]++] = v;
+    for (uint c = components; c > 0; --c)
+        first[c] = first[c - 1];
+    first[0] = 0;
+
+    vector<uint> seen(components, NONE);
+    _offsets.assign(components + 1, 0);
+    _successors.clear();
+
+    for (uint c = 0; c < components; ++c) {
+        _offsets[c] = _successors.size();
+        for (uint m = first[c]; m < first[c + 1]; ++m) {
+            uint v = members[m];
+            for (uint e = offsets[v]; e < offsets[v + 1]; ++e) {
+                uint d = _component[targets[e]];
+                if(d != c && seen[d] != c) {
+                    seen[d] = c;
+                    _successors.push_back(d);
+                }
+            }
+        }
+    }
+    _offsets[components] = _successors.size();
+}
+
+// A post order traversal of the DAG giving every component the rank it's finished with, and the lowest rank
+// reachable from it. The first traversal goes from the sources in order, and records the subtree intervals;
+// the others take the roots and the successors of each component from random starting points.
+void ReachabilityIndex::_label(uint traversal, uint seed) {
+    uint components = _tree.size();
+    mt19937 random(seed);
+
+    vector<uint> roots(components);
+    for (uint c = 0; c < components; ++c)
+        roots[c] = components - 1 - c;
+    if(traversal > 0)
+        shuffle(roots.begin(), roots.end(), random);
+
+    //Frames of the component, the position of its next successor, the successors left and the rank on entry
+    struct Frame {
+        uint c;
+        uint position;
+        uint left;
+        uint entry;
+    };
+    vector<Frame> frames;
+    uint search = ++_search, rank = 0;
+
+    for (uint root : roots) {
+        if(_stamp[root] == search)
+            continue;
+
+        uint c = root;
+        while(true) {
+            //Enter c
+            uint degree = _offsets[c + 1] - _offsets[c];
+            uint start = traversal > 0 && degree > 0 ? random() % degree : 0;
+            _stamp[c] = search;
+            _labels[(size_t) c * _k + traversal].low = rank;
+            frames.push_back(Frame{c, start, degree, rank});
+
+            uint next = NONE;
+            while(!frames.empty() && next == NONE) {
+                Frame& top = frames.back();
+                Interval& label = _labels[(size_t) top.c * _k + traversal];
+
+                while(top.left > 0 && next == NONE) {
+                    uint d = _successors[_offsets[top.c] + top.position];
+                    top.position = top.position + 1 == _offsets[top.c + 1] - _offsets[top.c] ? 0 : top.position + 1;
+                    top.left--;
+
+                    if(_stamp[d] != search)
+                        next = d;
+                    else
+                        label.low = min(label.low, _labels[(size_t) d * _k + traversal].low);
+                }
+
+                if(next != NONE)
+                    break;
+
+                //Finish the component on top
+                label.high = rank++;
+                if(traversal == 0)
+                    _tree[top.c] = Interval{top.entry, label.high};
+
+                uint low = label.low;
+                frames.pop_back();
+                if(!frames.empty()) {
+                    Interval& parent = _labels[(size_t) frames.back().c * _k + traversal];
+                    parent.low = min(parent.low, low);
+                }
+            }
+
+            if(next == NONE)
+                break;
+            c = next;
+        }
+    }
+}
+
+void ReachabilityIndex::_refresh() {
+    if(_g->getVersion() != _version)
+        _build();
+}
+
+// Reachability between components over the DAG and the pending edges: a chain of DAG paths joined by pending edges.
+bool ReachabilityIndex::_reachable(uint from, uint to) {
+    if(_reachableOnDAG(from, to))
+        return true;
+    if(_pending.empty())
+        return false;
+
+    vector<bool> used(_pending.size(), false);
+    vector<uint> frontier(1, from);
+    while(!frontier.empty()) {
+        uint c = frontier.back();
+        frontier.pop_back();
+
+        for (uint i = 0; i < _pending.size(); ++i) {
+            if(used[i] || !_reachableOnDAG(c, _pending[i].first))
+                continue;
+
+            used[i] = true;
+            if(_reachableOnDAG(_pending[i].second, to))
+                return true;
+            frontier.push_back(_pending[i].second);
+        }
+    }
+
+    return false;
+}
+
+bool ReachabilityIndex::_reachableOnDAG(uint from, uint to) {
+    if(from == to || _tree[from].contains(_tree[to]))
+        return true;
+    if(!_mayReach(from, to))
+        return false;
+
+    //Restart the stamps when they wrap around
+    _fallbacks++;
+    if(++_search == 0) {
+        fill(_stamp.begin(), _stamp.end(), 0);
+        _search = 1;
+    }
+
+    _stamp[from] = _search;
+    _stack.assign(1, from);
+    while(!_stack.empty()) {
+        uint c = _stack.back();
+        _stack.pop_back();
+
+        for (uint e = _offsets[c]; e < _offsets[c + 1]; ++e) {
+            uint d = _successors[e];
+            if(_stamp[d] == _search)
+                continue;
+
+            _stamp[d] = _search;
+            if(d == to || _tree[d].contains(_tree[to]))
+                return true;
+            if(_mayReach(d, to))
+                _stack.push_back(d);
+        }
+    }
+
+    return false;
+}
+
+// False if some label proves that to isn't reachable from from. Edges only go to lower numbers, and a component
+// reaches nothing out of the ranks of its labels.
+bool ReachabilityIndex::_mayReach(uint from, uint to) const {
+    if(from < to)
+        return false;
+
+    const Interval* fromLabels = _labels.data() + (size_t) from * _k;
+    const Interval* toLabels = _labels.data() + (size_t) to * _k;
+    for (uint i = 0; i < _k; ++i)
+        if(!fromLabels[i].contains(toLabels[i]))
+            return false;
+
+    return true;
+}
@@ -0,0 +1,116 @@
+#ifndef __REACHABILITY__H__
+#define __REACHABILITY__H__
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include "graph.h"
+
+/*
+ * An index answering "is the node to reachable from the node from" without traversing the graph.
+ * The strongly connected components of the graph are condensed into a DAG, numbered in reverse topological
+ * order, so an edge always goes from a component to one with a lower number. Every component gets:
+ *   - the interval of its subtree on a depth first spanning forest of the DAG: a node inside it is reachable.
+ *   - a few GRAIL labels, the interval between the lowest rank reachable from it and its own rank on randomized
+ *     post order traversals: a node with a label outside them isn't reachable.
+ * Most queries are answered by those intervals in constant time. The rest run a depth first search over the DAG,
+ * pruned by the same intervals.
+ * Edges applied through the index are kept apart while they don't change the reachability, and the index is built
+ * again once there are more than maxPending of them. If the graph is modified by any other way, the index is built
+ * again on the next query.
+ * The graph must outlive the index. Queries reuse scratch arrays of the index, so they aren't safe from several
+ * threads at once.
+ */
+class ReachabilityIndex {
+
+public:
+    /*
+     * Build the index of g with the given count of GRAIL labels per component. Costs O(labels * (V + E)).
+     */
+    ReachabilityIndex(Graph& g, uint labels = 3, uint maxPending = 64);
+
+    /*
+     * Return true if to is reachable from from. A node is always reachable from itself.
+     */
+    bool isReachable(uint from, uint to);
+
+    /*
+     * Apply the edge on the graph, as Graph::applyEdge, and update the index.
+     */
+    void applyEdge(uint v1, uint v2, float weight = 1);
+
+    /*
+     * Build the index again from the current graph, merging the pending edges.
+     */
+    void rebuild();
+
+    /*
+     * Return the count of strongly connected components of the graph when the index was built.
+     */
+    uint getComponentsCount() const;
+
+    /*
+     * Return the component of the node v when the index was built. Components are numbered in reverse
+     * topological order: if v2 is reachable from v1, getComponent(v1) >= getComponent(v2).
+     */
+    uint getComponent(uint v) const;
+
+    /*
+     * Return the count of edges applied since the index was built that aren't part of it yet.
+     */
+    uint getPendingEdgesCount() const;
+
+    /*
+     * Return the count of searches on the DAG run by the queries the intervals alone couldn't answer.
+     */
+    uint64_t getFallbacksCount() const;
+
+    /*
+     * Return the bytes taken by the index.
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    struct Interval {
+        uint low;
+        uint high;
+
+        bool contains(const Interval& other) const {
+            return low <= other.low && other.high <= high;
+        }
+    };
+
+    Graph* _g;
+    uint64_t _version;
+    uint _n;
+    uint _k;
+    uint _maxPending;
+    uint64_t _fallbacks;
+
+    //Component of every node, and the DAG of the components with its edges on _successors[_offsets[c].._offsets[c+1]]
+    std::vector<uint> _component;
+    std::vector<uint> _offsets;
+    std::vector<uint> _successors;
+
+    //_tree[c] is the subtree interval of c, _labels[c * k + i] its label on the traversal i
+    std::vector<Interval> _tree;
+    std::vector<Interval> _labels;
+
+    //Edges between components applied after the build
+    std::vector<std::pair<uint,uint> > _pending;
+
+    //Scratch of the searches, a component is visited if its stamp is the one of the current search
+    uint _search;
+    std::vector<uint> _stamp;
+    std::vector<uint> _stack;
+
+    void _build();
+    void _condense();
+    void _label(uint traversal, uint seed);
+    void _refresh();
+    bool _reachable(uint from, uint to);
+    bool _reachableOnDAG(uint from, uint to);
+    bool _mayReach(uint from, uint to) const;
+};
+
+#endif
@@ -0,0 +1,207 @@
+#include "shortest_paths.h"
+#include "parallel.h"
+#include <limits>
+#include <queue>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+    const float INF = numeric_limits<float>::infinity();
+    const uint NO_HOP = (uint) -1;
+
+}
+
+AllPairsShortestPaths::AllPairsShortestPaths(const Graph& g, bool withPaths) {
+    _n = g.getNodesCount();
+    _stride = (_n + TILE - 1) / TILE * TILE;
+    _withPaths = withPaths;
+
+    //Infinity keeps the sums saturated, DEFAULT_WEIGHT (FLT_MAX) would overflow into it anyway
+    _dist = vector<float>((size_t) _stride * _stride, INF);
+    if(_withPaths)
+        _next = vector<uint>((size_t) _stride * _stride, NO_HOP);
+
+    for (uint v = 0; v < _stride; ++v) {
+        _dist[(size_t) v * _stride + v] = 0;
+        if(_withPaths)
+            _next[(size_t) v * _stride + v] = v;
+    }
+
+    //Repeated edges of the lists keep the lightest one
+    for (uint v = 0; v < _n; ++v) {
+        for(auto it = g.adjacentsOf(v); it.thereIsMore(); it.advance()) {
+            size_t at = (size_t) v * _stride + it.next().first;
+            if(it.next().second < _dist[at]) {
+                _dist[at] = it.next().second;
+                if(_withPaths)
+                    _next[at] = it.next().first;
+            }
+        }
+    }
+
+    uint tiles = _stride / TILE;
+    for (uint tk = 0; tk < tiles; ++tk) {
+        //The diagonal tile depends only on itself
+        _relaxTile(tk, tk, tk);
+
+        //Tiles on the row and the column of the diagonal one depend on it and on themselves
+        parallelFor(0, tiles, [this, tk](uint t) {
+            if(t == tk) return;
+            _relaxTile(tk, t, tk);
+            _relaxTile(t, tk, tk);
+        }, 1);
+
+        //Every other tile depends on a row tile and a column tile, already final for this round
+        parallelFor(0, tiles, [this, tk, tiles](uint ti) {
+            if(ti == tk) return;
+            for (uint tj = 0; tj < tiles; ++tj)
+                if(tj != tk)
+                    _relaxTile(ti, tj, tk);
+        }, 1);
+    }
+}
+
+void AllPairsShortestPaths::_relaxTile(uint ti, uint tj, uint tk) {
+    for (uint k = tk * TILE; k < (tk + 1) * TILE; ++k) {
+        const float* rowK = &_dist[(size_t) k * _stride + tj * TILE];
+
+        for (uint i = ti * TILE; i < (ti + 1) * TILE; ++i) {
+            float throughK = _dist[(size_t) i * _stride + k];
+            if(throughK == INF) continue;
+
+            float* rowI = &_dist[(size_t) i * _stride + tj * TILE];
+
+            if(!_withPaths) {
+                for (uint j = 0; j < TILE; ++j) {
+                    float candidate = throughK + rowK[j];
+                    rowI[j] = candidate < rowI[j] ? candidate : rowI[j];
+                }
+
+            } else {
+                uint hop = _next[(size_t) i * _stride + k];
+                uint* hopsI = &_next[(size_t) i * _stride + tj * TILE];
+
+                //Select the hop with a mask, a branch would stop the vectorization
+                for (uint j = 0; j < TILE; ++j) {
+                    float candidate = throughK + rowK[j];
+                    uint shorter = -(uint) (candidate < rowI[j]);
+                    rowI[j] = candidate < rowI[j] ? candidate : rowI[j];
+                    hopsI[j] = (hop & shorter) | (hopsI[j] & ~shorter);
+                }
+            }
+        }
+    }
+}
+
+uint AllPairsShortestPaths::getNodesCount() const {
+    return _n;
+}
+
+float AllPairsShortestPaths::getDistance(uint from, uint to) const {
+    if(from >= _n || to >= _n)
+        throw invalid_argument("Invalid arguments on getDistance member function, from or to aren't nodes of the graph.");
+
+    float d = _dist[(size_t) from * _stride + to];
+    return d == INF ? DEFAULT_WEIGHT : d;
+}
+
+vector<uint> AllPairsShortestPaths::getPath(uint from, uint to) const {
+    if(from >= _n || to >= _n)
+        throw invalid_argument("Invalid arguments on getPath member function, from or to aren't nodes of the graph.");
+    if(!_withPaths)
+        throw invalid_argument("Invalid argument on getPath member function, the paths weren't computed.");
+
+    vector<uint> path;
+    if(_dist[(size_t) from * _stride + to] == INF)
+        return path;
+
+    //A negative cycle could make the hops loop, a path never has more than n nodes
+    path.push_back(from);
+    while(from != to && path.size() <= _n) {
+        from = _next[(size_t) from * _stride + to];
+        path.push_back(from);
+    }
+
+    return path;
+}
+
+bool AllPairsShortestPaths::hasNegativeCycle() const {
+    for (uint v = 0; v < _n; ++v)
+        if(_dist[(size_t) v * _stride + v] < 0)
+            return true;
+
+    return false;
+}
+
+SingleSourceShortestPaths::SingleSourceShortestPaths(const Graph& g, uint source) {
+    if(source >= g.getNodesCount())
+        throw invalid_argument("Invalid argument on SingleSourceShortestPaths constructor, source isn't a node of the graph.");
+
+    _source = source;
+    _dist = vector<float>(g.getNodesCount(), DEFAULT_WEIGHT);
+    _parent = vector<uint>(g.getNodesCount(), NO_HOP);
+
+    typedef pair<float,uint> Pending;
+    priority_queue<Pending, vector<Pending>, greater<Pending> > pending;
+
+    _dist[source] = 0;
+    _parent[source] = source;
+    pending.push(make_pair(0.0f, source));
+
+    while(!pending.empty()) {
+        Pending top = pending.top();
+        pending.pop();
+
+        //Stale entry, the node was settled with a shorter distance
+        if(top.first > _dist[top.second]) continue;
+
+        for(auto it = g.adjacentsOf(top.second); it.thereIsMore(); it.advance()) {
+            uint w = it.next().first;
+            float weight = it.next().second;
+
+            if(weight < 0)
+                throw invalid_argument("Invalid argument on SingleSourceShortestPaths constructor, the graph has a negative weight.");
+
+            if(top.first + weight < _dist[w]) {
+                _dist[w] = top.first + weight;
+                _parent[w] = top.second;
+                pending.push(make_pair(_dist[w], w));
+            }
+        }
+    }
+}
+
+uint SingleSourceShortestPaths::getSource() const {
+    return _source;
+}
+
+float SingleSourceShortestPaths::getDistance(uint to) const {
+    if(to >= _dist.size())
+        throw invalid_argument("Invalid argument on getDistance member function, to isn't a node of the graph.");
+
+    return _dist[to];
+}
+
+vector<uint> SingleSourceShortestPaths::getPath(uint to) const {
+    if(to >= _dist.size())
+        throw invalid_argument("Invalid argument on getPath member function, to isn't a node of the graph.");
+
+    vector<uint> path;
+    if(_parent[to] == NO_HOP)
+        return path;
+
+    for (uint v = to; v != _source; v = _parent[v])
+        path.push_back(v);
+    path.push_back(_source);
+
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+size_t SingleSourceShortestPaths::getMemoryUsage() const {
+    return sizeof(SingleSourceShortestPaths) + _dist.capacity() * sizeof(float) + _parent.capacity() * sizeof(uint);
+}
@@ -0,0 +1,96 @@
+#ifndef __SHORTEST_PATHS__H__
+#define __SHORTEST_PATHS__H__
+
+#include <vector>
+#include "graph.h"
+
+/*
+ * Shortest paths between every pair of nodes of a Graph, computed once by a cache-blocked Floyd-Warshall.
+ * The distances are kept on a dense matrix apart from the graph, padded to a whole count of tiles.
+ * Tiles are updated in three phases for every diagonal tile: the diagonal tile itself, the tiles of its
+ * row and column, and every other tile, the last two phases in parallel. The inner loop is a plain
+ * min/add over contiguous floats, vectorized by the compiler.
+ * Negative weights are allowed, an unreachable node is at DEFAULT_WEIGHT.
+ */
+class AllPairsShortestPaths {
+
+public:
+    /*
+     * Compute the distances of g. If withPaths is true, the first hop of every shortest path is
+     * also kept, to rebuild the paths with getPath.
+     */
+    AllPairsShortestPaths(const Graph& g, bool withPaths = false);
+
+    /*
+     * Get the cuantity of nodes of the graph.
+     */
+    uint getNodesCount() const;
+
+    /*
+     * Return the length of the shortest path from the node from to the node to, DEFAULT_WEIGHT if there is none.
+     */
+    float getDistance(uint from, uint to) const;
+
+    /*
+     * Return the nodes of a shortest path from the node from to the node to, both included.
+     * The path is empty if to isn't reachable from from.
+     */
+    std::vector<uint> getPath(uint from, uint to) const;
+
+    /*
+     * Return true if the graph has a cycle of negative length. Distances are meaningless then.
+     */
+    bool hasNegativeCycle() const;
+
+private:
+    static const uint TILE = 64;
+
+    uint _n;
+    uint _stride;
+    bool _withPaths;
+    std::vector<float> _dist;
+    std::vector<uint> _next;
+
+    void _relaxTile(uint ti, uint tj, uint tk);
+};
+
+/*
+ * Shortest paths from a single source node of a Graph, computed once by Dijkstra with a binary heap.
+ * Every weight must be non negative.
+ */
+class SingleSourceShortestPaths {
+
+public:
+    /*
+     * Compute the distances from source to every node of g.
+     */
+    SingleSourceShortestPaths(const Graph& g, uint source);
+
+    /*
+     * Return the source node of the paths.
+     */
+    uint getSource() const;
+
+    /*
+     * Return the length of the shortest path from the source to the node to, DEFAULT_WEIGHT if there is none.
+     */
+    float getDistance(uint to) const;
+
+    /*
+     * Return the nodes of a shortest path from the source to the node to, both included.
+     * The path is empty if to isn't reachable.
+     */
+    std::vector<uint> getPath(uint to) const;
+
+    /*
+     * Return the bytes taken by the distances and the paths.
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    uint _source;
+    std::vector<float> _dist;
+    std::vector<uint> _parent;
+};
+
+#endif
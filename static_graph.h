@@ -0,0 +1,334 @@
+#ifndef __STATIC_GRAPH__H__
+#define __STATIC_GRAPH__H__
+
+#include <cstdint>
+#include <utility>
+#include <limits>
+#include <stdexcept>
+
+typedef unsigned int uint;
+
+/*
+ * A graph of at most N nodes, sized at compile time, for the many tiny graphs (motifs, small dependency graphs)
+ * that don't deserve a Graph. The adjacencies are rows of N bits inside the object itself, and the iterators keep
+ * their state in fixed size arrays too, so a StaticGraph and its traversals never allocate memory: they live
+ * wherever they are declared, on the stack usually.
+ * Like an unweighted Graph over ADJACENCIES_MATRIX, it stores no weights: every edge weights 1. Neighbors are visited
+ * in increasing order, so the iterators give the same sequences as the ones of such a Graph.
+ * The queries that don't modify the graph are constexpr.
+ */
+template<uint N>
+class StaticGraph {
+
+    static_assert(N > 0, "A StaticGraph needs a capacity of one node at least.");
+
+public:
+    class AdjacentsIterator;
+    class DFSIterator;
+    class BFSIterator;
+
+    /*
+     * Construct a graph with n nodes, at most N. Nodes can be added later with addVertex, up to N.
+     */
+    constexpr StaticGraph(uint n = N, bool isOrientedGraph = false)
+        : _rows(), _linked(), _painted(),
+          _n(n <= N ? n : throw std::invalid_argument("Invalid argument on StaticGraph constructor, n is bigger than the capacity of the graph.")),
+          _oriented(isOrientedGraph), _edges(0) { }
+
+    /*
+     * Return the count of nodes the graph can hold.
+     */
+    static constexpr uint capacity() {
+        return N;
+    }
+
+    /*
+     * Applies an edge between the nodes v1 and v2. The weight is ignored, every edge weights 1.
+     */
+    void applyEdge(uint v1, uint v2, float = 1) {
+        if(v1 >= _n || v2 >= _n)
+            throw std::invalid_argument("Invalid arguments on applyEdge member function, v1 or v2 aren't nodes of the graph.");
+
+        if(!_test(_rows[v1], v2))
+            _edges++;
+
+        _set(_rows[v1], v2);
+        if(!_oriented)
+            _set(_rows[v2], v1);
+
+        _set(_linked, v1);
+        _set(_linked, v2);
+    }
+
+    /*
+     * Idem to Graph::areAdjacent.
+     */
+    constexpr bool areAdjacent(uint v1, uint v2) const {
+        return v1 < _n && v2 < _n ? _test(_rows[v1], v2)
+             : throw std::invalid_argument("Invalid arguments on areAdjacent member function, v1 or v2 aren't nodes of the graph.");
+    }
+
+    /*
+     * Return 1 if the nodes are adjacent, the biggest float (the DEFAULT_WEIGHT of a Graph) otherwise.
+     */
+    constexpr float getEdgeWeight(uint v1, uint v2) const {
+        return areAdjacent(v1, v2) ? 1 : std::numeric_limits<float>::max();
+    }
+
+    constexpr bool isOrientedGraph() const {
+        return _oriented;
+    }
+
+    constexpr uint getNodesCount() const {
+        return _n;
+    }
+
+    constexpr uint getEdgesCount() const {
+        return _edges;
+    }
+
+    /*
+     * Return the count of adjacents of v, a popcount of its row.
+     */
+    constexpr uint getDegree(uint v) const {
+        return v < _n ? _popcount(_rows[v], 0)
+             : throw std::invalid_argument("Invalid argument on getDegree member function, v isn't a node of the graph.");
+    }
+
+    /*
+     * Test if a node has no edge, in nor out.
+     */
+    constexpr bool isIsolatedNode(uint v) const {
+        return v < _n ? !_test(_linked, v)
+             : throw std::invalid_argument("Invalid argument on isIsolatedNode member function, v isn't a node of the graph.");
+    }
+
+    /*
+     * Add a new vertex, with out adjacents. Returns the new count of nodes.
+     */
+    uint addVertex() {
+        if(_n == N)
+            throw std::invalid_argument("Invalid argument on addVertex member function, the graph is full.");
+
+        return ++_n;
+    }
+
+    /*
+     * Fill the graph with all posible edges, self loops excluded.
+     */
+    void fill() {
+        for (uint v = 0; v < _n; ++v)
+            for (uint w = 0; w < _n; ++w)
+                if(v != w && !_test(_rows[v], w))
+                    applyEdge(v, w);
+    }
+
+    void paintNode(uint v) {
+        if(v >= _n)
+            throw std::invalid_argument("Invalid argument on paintNode member function, v isn't a node of the graph.");
+        _set(_painted, v);
+    }
+
+    constexpr bool paintedNode(uint v) const {
+        return v < _n ? _test(_painted, v)
+             : throw std::invalid_argument("Invalid argument on paintedNode member function, v isn't a node of the graph.");
+    }
+
+    void unpaintNode(uint v) {
+        if(v >= _n)
+            throw std::invalid_argument("Invalid argument on unpaintNode member function, v isn't a node of the graph.");
+        _painted[v / 64] &= ~((uint64_t) 1 << (v % 64));
+    }
+
+    /*
+     * Return an iterator of the adjacents nodes of v, in increasing order.
+     */
+    AdjacentsIterator adjacentsOf(uint v) const {
+        if(v >= _n)
+            throw std::invalid_argument("Invalid argument on adjacentsOf member function, v is not a node of the graph.");
+
+        return AdjacentsIterator(_rows[v]);
+    }
+
+    class AdjacentsIterator {
+
+        public:
+            /*
+             * Get current adjacent of the iterator, with a weight of 1. This not modify the iterator status.
+             */
+            std::pair<uint,float> next() const {
+                return std::make_pair(_word * 64 + (uint) __builtin_ctzll(_bits[_word]), 1.0f);
+            }
+
+            /*
+             * Indicates if exist an adjacent node pending for review
+             */
+            bool thereIsMore() const {
+                return _word < WORDS;
+            }
+
+            /*
+             * Moves the iterator to the next adjacent: clears the lowest bit of the row.
+             */
+            void advance() {
+                _bits[_word] &= _bits[_word] - 1;
+                _skipEmpty();
+            }
+
+        private:
+            friend class StaticGraph;
+
+            uint64_t _bits[(N + 63) / 64];
+            uint _word;
+
+            AdjacentsIterator(const uint64_t (&row)[(N + 63) / 64]) : _word(0) {
+                for (uint i = 0; i < WORDS; ++i)
+                    _bits[i] = row[i];
+                _skipEmpty();
+            }
+
+            void _skipEmpty() {
+                while(_word < WORDS && _bits[_word] == 0)
+                    _word++;
+            }
+    };
+
+    /*
+     * Depth first traversal, in the same order as a Graph::DFSIterator. Each visited node keeps the set of
+     * its adjacents still unvisited when it was reached, and the traversal continues from the highest of them
+     * on the latest node, as the stack of a Graph::DFSIterator does.
+     */
+    class DFSIterator {
+
+        public:
+            DFSIterator(uint source, const StaticGraph* g) : _g(g), _visited(), _depth(0), _current(source), _more(true) {
+                if(source >= g->_n)
+                    throw std::invalid_argument("Invalid argument on DFSIterator constructor, source is not a node of the graph.");
+
+                _visit(source);
+            }
+
+            /*
+             * Get current node of the iterator. This not modify the iterator status.
+             */
+            uint next() const {
+                return _current;
+            }
+
+            void advance() {
+                while(_depth > 0) {
+                    uint64_t* pending = _pending[_depth - 1];
+
+                    uint word = WORDS;
+                    while(word > 0 && pending[word - 1] == 0)
+                        word--;
+
+                    if(word == 0) {
+                        _depth--;
+                        continue;
+                    }
+
+                    uint bit = 63 - __builtin_clzll(pending[word - 1]);
+                    pending[word - 1] &= ~((uint64_t) 1 << bit);
+
+                    uint w = (word - 1) * 64 + bit;
+                    if(!_test(_visited, w)) {
+                        _current = w;
+                        _visit(w);
+                        return;
+                    }
+                }
+
+                _more = false;
+            }
+
+            bool thereIsMore() const {
+                return _more;
+            }
+
+        private:
+            const StaticGraph* _g;
+            uint64_t _visited[(N + 63) / 64];
+            uint64_t _pending[N][(N + 63) / 64];
+            uint _depth;
+            uint _current;
+            bool _more;
+
+            void _visit(uint v) {
+                _set(_visited, v);
+                for (uint i = 0; i < WORDS; ++i)
+                    _pending[_depth][i] = _g->_rows[v][i] & ~_visited[i];
+                _depth++;
+            }
+    };
+
+    /*
+     * Breadth first traversal, in the same order as a Graph::BFSIterator, over a fixed queue of N nodes.
+     */
+    class BFSIterator {
+
+        public:
+            BFSIterator(uint source, const StaticGraph* g) : _g(g), _discovered(), _head(0), _tail(0) {
+                if(source >= g->_n)
+                    throw std::invalid_argument("Invalid argument on BFSIterator constructor, source is not a node of the graph.");
+
+                _set(_discovered, source);
+                _queue[_tail++] = source;
+            }
+
+            /*
+             * Get current node of the iterator. This not modify the iterator status.
+             */
+            uint next() const {
+                return _queue[_head];
+            }
+
+            void advance() {
+                uint v = _queue[_head++];
+
+                for (uint i = 0; i < WORDS; ++i) {
+                    uint64_t fresh = _g->_rows[v][i] & ~_discovered[i];
+                    _discovered[i] |= fresh;
+
+                    for (; fresh != 0; fresh &= fresh - 1)
+                        _queue[_tail++] = i * 64 + __builtin_ctzll(fresh);
+                }
+            }
+
+            bool thereIsMore() const {
+                return _head < _tail;
+            }
+
+        private:
+            const StaticGraph* _g;
+            uint64_t _discovered[(N + 63) / 64];
+            uint _queue[N];
+            uint _head;
+            uint _tail;
+    };
+
+private:
+    static const uint WORDS = (N + 63) / 64;
+    typedef uint64_t Row[WORDS];
+
+    Row _rows[N];
+    Row _linked;
+    Row _painted;
+    uint _n;
+    bool _oriented;
+    uint _edges;
+
+    static constexpr bool _test(const Row& bits, uint i) {
+        return (bits[i / 64] >> (i % 64)) & 1;
+    }
+
+    static void _set(Row& bits, uint i) {
+        bits[i / 64] |= (uint64_t) 1 << (i % 64);
+    }
+
+    static constexpr uint _popcount(const Row& bits, uint word) {
+        return word == WORDS ? 0 : __builtin_popcountll(bits[word]) + _popcount(bits, word + 1);
+    }
+};
+
+#endif
@@ -3,7 +3,15 @@
 #include <utility>
 #include <algorithm>
 #include <set>
+#include <chrono>
+#include <cstdio>
 #include "graph.h"
+#include "arena.h"
+#include "shortest_paths.h"
+#include "query_cache.h"
+#include "landmarks.h"
+#include "static_graph.h"
+#include "reachability.h"
 
 using namespace std;
 
@@ -26,6 +34,337 @@ void stress_test(IMPL impl) {
     }
 }
 
+double elapsed_ms(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - since).count();
+}
+
+/*
+ * Build and traverse many short-lived graphs, allocating with the global operator new (glibc malloc)
+ * or with a monotonic arena released after each graph.
+ */
+double short_lived_graphs(IMPL impl, Arena* arena) {
+    uint graphs_q = 2000, nodes_q = 200, edges_q = 1000;
+
+    srand(42);
+    auto start = chrono::steady_clock::now();
+    for (uint i = 0; i < graphs_q; ++i) {
+        {
+            Graph g(nodes_q, true, impl, true, arena);
+            for (uint e = 0; e < edges_q; ++e) {
+                uint from = rand()%nodes_q, to = rand()%nodes_q;
+                if(from != to)
+                    g.applyEdge(from, to, rand());
+            }
+
+            for (Graph::BFSIterator it(0, &g); it.thereIsMore(); it.advance());
+        }
+
+        if(arena != NULL)
+            arena->release();
+    }
+
+    return elapsed_ms(start);
+}
+
+void arena_benchmark(IMPL impl) {
+    Arena arena;
+
+    double heap = short_lived_graphs(impl, NULL);
+    double monotonic = short_lived_graphs(impl, &arena);
+
+    printf("malloc: %.0f ms, arena: %.0f ms... ", heap, monotonic);
+}
+
+uint find_root(vector<uint>& parent, uint v) {
+    while(parent[v] != v)
+        v = parent[v] = parent[parent[v]];
+    return v;
+}
+
+double forest_weight(const vector<Graph::Edge*>& forest) {
+    double total = 0;
+    for (const Graph::Edge* e : forest)
+        total += e->weight;
+    return total;
+}
+
+/*
+ * Baseline spanning forest: copy the edges, sort them and join them with a union-find. Returns its total weight.
+ */
+double sorted_copy_forest(Graph& g) {
+    vector<Graph::Edge> edges(g.getEdges().begin(), g.getEdges().end());
+    sort(edges.begin(), edges.end(), [](const Graph::Edge& a, const Graph::Edge& b) { return a.weight < b.weight; });
+
+    vector<uint> parent(g.getNodesCount());
+    for (uint v = 0; v < parent.size(); ++v) parent[v] = v;
+
+    double total = 0;
+    for (const auto& e : edges) {
+        uint a = find_root(parent, e.from), b = find_root(parent, e.to);
+        if(a != b) {
+            parent[a] = b;
+            total += e.weight;
+        }
+    }
+
+    return total;
+}
+
+void compare_forests(Graph& g) {
+    auto start = chrono::steady_clock::now();
+    double baseline = sorted_copy_forest(g);
+    double sorted_ms = elapsed_ms(start);
+
+    start = chrono::steady_clock::now();
+    double kruskal = forest_weight(g.minimumSpanningForest(false, KRUSKAL_FOREST));
+    double kruskal_ms = elapsed_ms(start);
+
+    start = chrono::steady_clock::now();
+    double boruvka = forest_weight(g.minimumSpanningForest(false, BORUVKA_FOREST));
+    double boruvka_ms = elapsed_ms(start);
+
+    assert(kruskal == baseline && boruvka == baseline);
+    printf("[n=%u m=%u sort+union-find: %.0f ms, filter-Kruskal: %.0f ms, Boruvka: %.0f ms] ",
+           g.getNodesCount(), g.getEdgesCount(), sorted_ms, kruskal_ms, boruvka_ms);
+}
+
+void spanning_forest_benchmark(IMPL impl) {
+    uint dense_q = 1500;
+    Graph dense(dense_q, false, impl);
+    dense.fill();
+    compare_forests(dense);
+
+    uint sparse_q = impl == ADJACENCIES_LIST ? 200000 : 5000;
+    Graph sparse(sparse_q, false, impl);
+    srand(42);
+    for (uint i = 0; i < sparse_q * 5; ++i) {
+        uint from = rand()%sparse_q, to = rand()%sparse_q;
+        if(from != to)
+            sparse.applyEdge(from, to, rand()%1000);
+    }
+    compare_forests(sparse);
+}
+
+void shortest_paths_benchmark(IMPL impl) {
+    uint q = 1500;
+    Graph g(q, true, impl);
+    srand(42);
+    for (uint i = 0; i < q; ++i)
+        for (uint j = 0; j < q; ++j)
+            if(i != j)
+                g.applyEdge(i, j, 1 + rand()%1000);
+
+    //Baseline: copy the weights out and run the naive triple loop
+    auto start = chrono::steady_clock::now();
+    vector<vector<float> > dist(q, vector<float>(q));
+    for (uint i = 0; i < q; ++i)
+        for (uint j = 0; j < q; ++j)
+            dist[i][j] = i == j ? 0 : g.getEdgeWeight(i, j);
+    for (uint k = 0; k < q; ++k)
+        for (uint i = 0; i < q; ++i)
+            for (uint j = 0; j < q; ++j)
+                dist[i][j] = min(dist[i][j], dist[i][k] + dist[k][j]);
+    double naive_ms = elapsed_ms(start);
+
+    start = chrono::steady_clock::now();
+    AllPairsShortestPaths apsp(g);
+    double blocked_ms = elapsed_ms(start);
+
+    for (uint i = 0; i < q; ++i)
+        for (uint j = 0; j < q; ++j)
+            assert(apsp.getDistance(i, j) == dist[i][j]);
+
+    printf("[n=%u naive: %.0f ms, blocked: %.0f ms] ", q, naive_ms, blocked_ms);
+}
+
+void print_conversion(const Graph::ConversionReport& report) {
+    printf("[%s -> %s density %.4f: %zu KB -> %zu KB in %.0f ms] ",
+           report.from == ADJACENCIES_LIST ? "list" : "matrix", report.to == ADJACENCIES_LIST ? "list" : "matrix",
+           report.density, report.bytesBefore / 1024, report.bytesAfter / 1024, report.seconds * 1000);
+}
+
+void conversion_benchmark() {
+    uint q = 10000;
+    Graph g(q, false, ADJACENCIES_LIST);
+    srand(42);
+    for (uint i = 0; i < q * 5; ++i) {
+        uint from = rand()%q, to = rand()%q;
+        if(from != to)
+            g.applyEdge(from, to, rand()%1000);
+    }
+
+    print_conversion(g.convertTo(ADJACENCIES_MATRIX));
+    print_conversion(g.convertTo(ADJACENCIES_LIST));
+}
+
+void query_cache_benchmark(IMPL impl) {
+    uint q = impl == ADJACENCIES_LIST ? 20000 : 2000;
+    Graph g(q, true, impl);
+    srand(42);
+    for (uint i = 0; i < q * 5; ++i) {
+        uint from = rand()%q, to = rand()%q;
+        if(from != to)
+            g.applyEdge(from, to, rand()%1000);
+    }
+
+    uint sources = 10, repeats = 5;
+
+    auto start = chrono::steady_clock::now();
+    size_t walked = 0;
+    for (uint r = 0; r < repeats; ++r)
+        for (uint s = 0; s < sources; ++s)
+            for (Graph::BFSIterator it(s, &g); it.thereIsMore(); it.advance())
+                walked++;
+    double raw_ms = elapsed_ms(start);
+
+    start = chrono::steady_clock::now();
+    QueryCache cache(g);
+    size_t cached = 0;
+    for (uint r = 0; r < repeats; ++r)
+        for (uint s = 0; s < sources; ++s)
+            cached += cache.BFS(s).size();
+    double cached_ms = elapsed_ms(start);
+
+    assert(cached == walked);
+    printf("[%u BFS x %u: uncached %.0f ms, cached %.0f ms, hit rate %.2f] ",
+           sources, repeats, raw_ms, cached_ms, cache.getHitRate());
+}
+
+void landmarks_benchmark(IMPL impl) {
+    //A grid with random weights, like a road network
+    uint side = impl == ADJACENCIES_LIST ? 200 : 60;
+    uint q = side * side;
+    Graph g(q, false, impl);
+    srand(42);
+    for (uint r = 0; r < side; ++r) {
+        for (uint c = 0; c < side; ++c) {
+            if(c + 1 < side) g.applyEdge(r * side + c, r * side + c + 1, 1 + rand()%100);
+            if(r + 1 < side) g.applyEdge(r * side + c, (r + 1) * side + c, 1 + rand()%100);
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    LandmarkIndex index(g, 8);
+    double build_ms = elapsed_ms(start);
+
+    index.save("landmarks_benchmark.alt");
+    start = chrono::steady_clock::now();
+    LandmarkIndex loaded = LandmarkIndex::load(g, "landmarks_benchmark.alt");
+    double load_ms = elapsed_ms(start);
+    remove("landmarks_benchmark.alt");
+
+    uint queries = 50;
+    vector<pair<uint,uint> > pairs;
+    for (uint i = 0; i < queries; ++i)
+        pairs.push_back(make_pair(rand()%q, rand()%q));
+
+    start = chrono::steady_clock::now();
+    vector<float> expected;
+    for (const auto& p : pairs)
+        expected.push_back(SingleSourceShortestPaths(g, p.first).getDistance(p.second));
+    double dijkstra_ms = elapsed_ms(start);
+
+    start = chrono::steady_clock::now();
+    size_t settled = 0;
+    for (uint i = 0; i < queries; ++i) {
+        assert(loaded.getDistance(pairs[i].first, pairs[i].second) == expected[i]);
+        settled += loaded.getLastSettledCount();
+    }
+    double alt_ms = elapsed_ms(start);
+
+    printf("[n=%u build: %.0f ms, load: %.0f ms, %u queries: dijkstra %.0f ms, ALT %.0f ms settling %.1f%% of the nodes] ",
+           q, build_ms, load_ms, queries, dijkstra_ms, alt_ms, 100.0 * settled / queries / q);
+}
+
+void static_graph_benchmark() {
+    uint graphs = 200000, q = 16, edges = 24;
+
+    srand(42);
+    auto start = chrono::steady_clock::now();
+    size_t reached = 0;
+    for (uint i = 0; i < graphs; ++i) {
+        Graph g(q, false, ADJACENCIES_MATRIX, false);
+        for (uint e = 0; e < edges; ++e)
+            g.applyEdge(rand()%q, rand()%q);
+        for (Graph::BFSIterator it(0, &g); it.thereIsMore(); it.advance())
+            reached++;
+    }
+    double graph_ms = elapsed_ms(start);
+
+    srand(42);
+    start = chrono::steady_clock::now();
+    size_t staticReached = 0;
+    for (uint i = 0; i < graphs; ++i) {
+        StaticGraph<16> g(q);
+        for (uint e = 0; e < edges; ++e)
+            g.applyEdge(rand()%q, rand()%q);
+        for (StaticGraph<16>::BFSIterator it(0, &g); it.thereIsMore(); it.advance())
+            staticReached++;
+    }
+    double static_ms = elapsed_ms(start);
+
+    assert(reached == staticReached);
+    printf("[%u graphs of %u nodes, build + BFS: Graph %.0f ms, StaticGraph<16> %.0f ms] ", graphs, q, graph_ms, static_ms);
+}
+
+void reachability_benchmark(IMPL impl) {
+    //Mostly forward edges between nearby nodes, with a few backward ones closing cycles
+    uint q = impl == ADJACENCIES_LIST ? 100000 : 10000, window = q / 50;
+    Graph g(q, true, impl);
+    srand(42);
+    for (uint v = 0; v < q; ++v) {
+        for (uint e = 0; e < 2; ++e) {
+            uint w = min(q - 1, v + 1 + rand()%window);
+            if(rand()%100 == 0)
+                g.applyEdge(w, v);
+            else
+                g.applyEdge(v, w);
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    ReachabilityIndex index(g);
+    double build_ms = elapsed_ms(start);
+
+    uint queries = 100000, dfs_queries = 200;
+    vector<pair<uint,uint> > pairs;
+    for (uint i = 0; i < queries; ++i) {
+        uint from = rand()%q;
+        pairs.push_back(make_pair(from, min(q - 1, from + rand()%(10 * window))));
+    }
+
+    //A DFS from the source until the target appears
+    start = chrono::steady_clock::now();
+    vector<bool> expected;
+    for (uint i = 0; i < dfs_queries; ++i) {
+        bool found = false;
+        for (Graph::DFSIterator it(pairs[i].first, &g); !found && it.thereIsMore(); it.advance())
+            found = it.next() == pairs[i].second;
+        expected.push_back(found);
+    }
+    double dfs_ms = elapsed_ms(start);
+
+    start = chrono::steady_clock::now();
+    uint reachable = 0;
+    for (uint i = 0; i < queries; ++i) {
+        bool found = index.isReachable(pairs[i].first, pairs[i].second);
+        assert(i >= dfs_queries || found == expected[i]);
+        reachable += found;
+    }
+    double index_ms = elapsed_ms(start);
+    uint64_t fallbacks = index.getFallbacksCount();
+
+    start = chrono::steady_clock::now();
+    for (uint i = 0; i < 1000; ++i)
+        index.applyEdge(rand()%q, rand()%q);
+    index.isReachable(0, q - 1);
+    double update_ms = elapsed_ms(start);
+
+    printf("[n=%u, %u components, build: %.0f ms, DFS %.2f ms/query, index %.4f ms/query (%.1f%% reachable, %.1f%% searched), 1000 edges: %.0f ms] ",
+           q, index.getComponentsCount(), build_ms, dfs_ms / dfs_queries, index_ms / queries,
+           100.0 * reachable / queries, 100.0 * fallbacks / queries, update_ms);
+}
+
 int main() {
     printf("stress_test (ADJACENCIES_LIST) started... ");
     stress_test(ADJACENCIES_LIST);
@@ -35,5 +374,57 @@ int main() {
     stress_test(ADJACENCIES_MATRIX);
     printf("passed!\n");
 
+    printf("arena_benchmark (ADJACENCIES_LIST) started... ");
+    arena_benchmark(ADJACENCIES_LIST);
+    printf("passed!\n");
+
+    printf("arena_benchmark (ADJACENCIES_MATRIX) started... ");
+    arena_benchmark(ADJACENCIES_MATRIX);
+    printf("passed!\n");
+
+    printf("spanning_forest_benchmark (ADJACENCIES_LIST) started... ");
+    spanning_forest_benchmark(ADJACENCIES_LIST);
+    printf("passed!\n");
+
+    printf("spanning_forest_benchmark (ADJACENCIES_MATRIX) started... ");
+    spanning_forest_benchmark(ADJACENCIES_MATRIX);
+    printf("passed!\n");
+
+    printf("shortest_paths_benchmark (ADJACENCIES_MATRIX) started... ");
+    shortest_paths_benchmark(ADJACENCIES_MATRIX);
+    printf("passed!\n");
+
+    printf("conversion_benchmark started... ");
+    conversion_benchmark();
+    printf("passed!\n");
+
+    printf("query_cache_benchmark (ADJACENCIES_LIST) started... ");
+    query_cache_benchmark(ADJACENCIES_LIST);
+    printf("passed!\n");
+
+    printf("query_cache_benchmark (ADJACENCIES_MATRIX) started... ");
+    query_cache_benchmark(ADJACENCIES_MATRIX);
+    printf("passed!\n");
+
+    printf("landmarks_benchmark (ADJACENCIES_LIST) started... ");
+    landmarks_benchmark(ADJACENCIES_LIST);
+    printf("passed!\n");
+
+    printf("landmarks_benchmark (ADJACENCIES_MATRIX) started... ");
+    landmarks_benchmark(ADJACENCIES_MATRIX);
+    printf("passed!\n");
+
+    printf("static_graph_benchmark started... ");
+    static_graph_benchmark();
+    printf("passed!\n");
+
+    printf("reachability_benchmark (ADJACENCIES_LIST) started... ");
+    reachability_benchmark(ADJACENCIES_LIST);
+    printf("passed!\n");
+
+    printf("reachability_benchmark (ADJACENCIES_MATRIX) started... ");
+    reachability_benchmark(ADJACENCIES_MATRIX);
+    printf("passed!\n");
+
     printf("\nAll test passed!!!!!!!\n\n");
 }
\ No newline at end of file
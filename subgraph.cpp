@@ -0,0 +1,182 @@
+#include "subgraph.h"
+#include "parallel.h"
+#include <memory>
+#include <utility>
+#include <stdexcept>
+#include <unordered_set>
+
+using namespace std;
+
+SubgraphView::SubgraphView(const Graph& g, const vector<bool>& nodes, EdgePredicate edges) {
+    if(!nodes.empty() && nodes.size() != g.getNodesCount())
+        throw invalid_argument("Invalid argument on SubgraphView constructor, the nodes mask size must be the count of nodes of the graph.");
+
+    _g = &g;
+    _nodes = nodes;
+    _edges = edges;
+}
+
+SubgraphView SubgraphView::induced(const Graph& g, const vector<uint>& nodes) {
+    vector<bool> mask(g.getNodesCount(), false);
+
+    for (uint v : nodes) {
+        if(v >= mask.size())
+            throw invalid_argument("Invalid argument on induced member function, a node isn't a node of the graph.");
+        mask[v] = true;
+    }
+
+    return SubgraphView(g, mask);
+}
+
+SubgraphView SubgraphView::withMaxWeight(const Graph& g, float maxWeight) {
+    return SubgraphView(g, vector<bool>(), [maxWeight](uint, uint, float weight) { return weight <= maxWeight; });
+}
+
+SubgraphView SubgraphView::painted(const Graph& g) {
+    vector<bool> mask(g.getNodesCount(), false);
+    for (uint v = 0; v < mask.size(); ++v)
+        mask[v] = g.paintedNode(v);
+
+    //Painted edges are only known by the edges list, index them by their ends
+    bool oriented = g.isOrientedGraph();
+    shared_ptr<unordered_set<uint64_t> > paintedEdges(new unordered_set<uint64_t>());
+    for (const auto& e : g.getEdges()) {
+        if(!g.paintedEdge(&e)) continue;
+
+        paintedEdges->insert(((uint64_t) e.from << 32) | e.to);
+        if(!oriented)
+            paintedEdges->insert(((uint64_t) e.to << 32) | e.from);
+    }
+
+    return SubgraphView(g, mask, [paintedEdges](uint from, uint to, float) {
+        return paintedEdges->count(((uint64_t) from << 32) | to) > 0;
+    });
+}
+
+const Graph& SubgraphView::getGraph() const {
+    return *_g;
+}
+
+uint SubgraphView::getNodesCount() const {
+    return _g->getNodesCount();
+}
+
+bool SubgraphView::containsNode(uint v) const {
+    if(v >= _g->getNodesCount())
+        throw invalid_argument("Invalid argument on containsNode member function, v isn't a node of the graph.");
+
+    return v >= _nodes.size() || _nodes[v];
+}
+
+bool SubgraphView::containsEdge(uint from, uint to, float weight) const {
+    return containsNode(from) && containsNode(to) && (!_edges || _edges(from, to, weight));
+}
+
+bool SubgraphView::areAdjacent(uint v1, uint v2) const {
+    if(!_g->areAdjacent(v1, v2) || !containsNode(v1) || !containsNode(v2))
+        return false;
+    if(!_edges)
+        return true;
+
+    //Parallel list edges may have different weights, any of them in the view is enough
+    for(auto it = _g->adjacentsOf(v1); it.thereIsMore(); it.advance())
+        if(it.next().first == v2 && _edges(v1, v2, it.next().second))
+            return true;
+
+    return false;
+}
+
+const SubgraphView::AdjacentsIterator SubgraphView::adjacentsOf(uint v) const {
+    if(v >= _g->getNodesCount())
+        throw invalid_argument("Invalid argument on adjacentsOf member function, v is not a node of the graph.");
+
+    return AdjacentsIterator(this, v);
+}
+
+Graph SubgraphView::materialize(vector<uint>* mapping) const {
+    uint n = _g->getNodesCount();
+    const uint NONE = (uint) -1;
+
+    vector<uint> compact(n, NONE), original;
+    for (uint v = 0; v < n; ++v) {
+        if(containsNode(v)) {
+            compact[v] = original.size();
+            original.push_back(v);
+        }
+    }
+
+    //Filter the neighbors of every node in parallel, the graph itself is only read
+    vector<vector<pair<uint,float> > > adjacents(original.size());
+    parallelFor(0, original.size(), [&](uint i) {
+        for(auto it = adjacentsOf(original[i]); it.thereIsMore(); it.advance())
+            adjacents[i].push_back(make_pair(compact[it.next().first], it.next().second));
+    });
+
+    Graph copy(original.size(), _g->isOrientedGraph(), _g->getImplementation(), _g->isWeightedGraph());
+    bool oriented = _g->isOrientedGraph();
+
+    for (uint i = 0; i < original.size(); ++i) {
+        if(_g->paintedNode(original[i]))
+            copy.paintNode(i);
+
+        //A non-oriented edge is seen from both ends, apply it once. A self loop is seen once on a matrix,
+        //but twice on the lists
+        uint loops = 0;
+        for (const auto& a : adjacents[i]) {
+            if(!oriented && i == a.first && _g->getImplementation() == ADJACENCIES_LIST && loops++ % 2 == 1)
+                continue;
+            if(oriented || i <= a.first)
+                copy.applyEdge(i, a.first, a.second);
+        }
+    }
+
+    if(mapping != NULL)
+        mapping->swap(original);
+
+    return copy;
+}
+
+
+/*
+ * Adjacents iterator implementation, over the iterator of the viewed graph.
+ */
+
+SubgraphView::AdjacentsIterator::AdjacentsIterator(const SubgraphView* view, uint v)
+    : _view(view), _from(v), _adjacents(view->_g->adjacentsOf(v)) {
+    _skipFiltered();
+}
+
+pair<uint,float> SubgraphView::AdjacentsIterator::next() const {
+    return _adjacents.next();
+}
+
+bool SubgraphView::AdjacentsIterator::thereIsMore() const {
+    return _adjacents.thereIsMore();
+}
+
+void SubgraphView::AdjacentsIterator::advance() {
+    _adjacents.advance();
+    _skipFiltered();
+}
+
+void SubgraphView::AdjacentsIterator::_skipFiltered() {
+    while(_adjacents.thereIsMore() && !_view->containsEdge(_from, _adjacents.next().first, _adjacents.next().second))
+        _adjacents.advance();
+}
+
+
+/*
+ * DFS and BFS iterators implementation.
+ */
+
+SubgraphView::DFSIterator::DFSIterator(uint source, const SubgraphView* g)
+    : DFSTraversal<SubgraphView>(source, g, g->getGraph().getArena()) {
+    if(!g->containsNode(source))
+        throw invalid_argument("Invalid argument on DFSIterator constructor, source is not a node of the subgraph.");
+}
+
+SubgraphView::BFSIterator::BFSIterator(uint source, const SubgraphView* g)
+    : BFSTraversal<SubgraphView>(source, g, g->getGraph().getArena()) {
+    if(!g->containsNode(source))
+        throw invalid_argument("Invalid argument on BFSIterator constructor, source is not a node of the subgraph.");
+}
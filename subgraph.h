@@ -0,0 +1,139 @@
+#ifndef __SUBGRAPH__H__
+#define __SUBGRAPH__H__
+
+#include <vector>
+#include <functional>
+#include "graph.h"
+#include "traversal.h"
+
+/*
+ * A lightweight view over a part of a Graph, without copying it.
+ * The view keeps the nodes selected by a mask and the edges between them accepted by a predicate.
+ * Nodes keep their numbers of the original graph. The view reads the graph on every query, so the
+ * graph must outlive the view, and changes on the graph are seen through it.
+ */
+class SubgraphView {
+
+public:
+    class AdjacentsIterator;
+    class DFSIterator;
+    class BFSIterator;
+
+    /*
+     * Predicate deciding if the edge (from, to) with the given weight belongs to the view.
+     */
+    typedef std::function<bool(uint from, uint to, float weight)> EdgePredicate;
+
+    /*
+     * Construct a view over g with the nodes v such that nodes[v] is true. An empty mask selects every node.
+     * If an edge predicate is given, only the edges accepted by it are part of the view.
+     */
+    SubgraphView(const Graph& g, const std::vector<bool>& nodes = std::vector<bool>(), EdgePredicate edges = EdgePredicate());
+
+    /*
+     * The subgraph induced by the given nodes, with every edge between them.
+     */
+    static SubgraphView induced(const Graph& g, const std::vector<uint>& nodes);
+
+    /*
+     * Every node, but only the edges with a weight lower or equal than maxWeight.
+     */
+    static SubgraphView withMaxWeight(const Graph& g, float maxWeight);
+
+    /*
+     * Only the painted nodes and the painted edges between them.
+     */
+    static SubgraphView painted(const Graph& g);
+
+    /*
+     * Return the viewed graph.
+     */
+    const Graph& getGraph() const;
+
+    /*
+     * Get the cuantity of nodes of the viewed graph, that is, the space of node numbers of the view.
+     */
+    uint getNodesCount() const;
+
+    /*
+     * Return true if the node v belongs to the view.
+     */
+    bool containsNode(uint v) const;
+
+    /*
+     * Return true if the edge (from, to) with the given weight belongs to the view. Both ends must belong to it.
+     */
+    bool containsEdge(uint from, uint to, float weight) const;
+
+    /*
+     * Idem to Graph::areAdjacent, restricted to the nodes and edges of the view.
+     */
+    bool areAdjacent(uint v1, uint v2) const;
+
+    /*
+     * Return an iterator of the adjacents nodes of v inside the view.
+     */
+    const AdjacentsIterator adjacentsOf(uint v) const;
+
+    /*
+     * Build a compact copy of the view: the selected nodes are renumbered from 0 in increasing order,
+     * keeping the orientation, implementation and weighted mode of the viewed graph, and the painted nodes.
+     * The neighbors of the nodes are filtered in parallel, so the edge predicate must be safe to call
+     * from several threads at once. If mapping is not NULL, it is filled with the
+     * number on the viewed graph of each node of the copy.
+     */
+    Graph materialize(std::vector<uint>* mapping = NULL) const;
+
+    class AdjacentsIterator {
+
+        public:
+            AdjacentsIterator(const SubgraphView* view, uint v);
+
+            /*
+             * Get current adjacent of the iterator. This not modify the iterator status.
+             */
+            std::pair<uint,float> next() const;
+
+            /*
+             * Indicates if exist an adjacent node pending for review
+             */
+            bool thereIsMore() const;
+
+            /*
+             * Moves the iterator to the next adjacent inside the view.
+             */
+            void advance();
+
+        private:
+            const SubgraphView* _view;
+            uint _from;
+            Graph::AdjacentsIterator _adjacents;
+
+            void _skipFiltered();
+    };
+
+    /*
+     * Depth first traversal of the view from one of its nodes, allocating from the arena of the viewed graph.
+     */
+    class DFSIterator : public DFSTraversal<SubgraphView> {
+
+        public:
+            DFSIterator(uint source, const SubgraphView* g);
+    };
+
+    /*
+     * Breadth first traversal of the view from one of its nodes, allocating from the arena of the viewed graph.
+     */
+    class BFSIterator : public BFSTraversal<SubgraphView> {
+
+        public:
+            BFSIterator(uint source, const SubgraphView* g);
+    };
+
+private:
+    const Graph* _g;
+    std::vector<bool> _nodes;
+    EdgePredicate _edges;
+};
+
+#endif
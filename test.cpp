@@ -3,7 +3,23 @@
 #include <utility>
 #include <algorithm>
 #include <set>
+#include <queue>
+#include <cmath>
+#include <string>
+#include <stdexcept>
+#include <cstdio>
+#include <thread>
+#include <type_traits>
+#include <limits>
 #include "graph.h"
+#include "partition.h"
+#include "compressed.h"
+#include "subgraph.h"
+#include "shortest_paths.h"
+#include "query_cache.h"
+#include "landmarks.h"
+#include "static_graph.h"
+#include "reachability.h"
 
 typedef unsigned int uint;
 
@@ -49,7 +65,7 @@ void test_addAndGetEdges(IMPL impl) {
     }
 
     //Compare edges vs edges stored in the auxiliar structure
-    list<Graph::Edge>& edges = g.getEdges();
+    Graph::EdgeList& edges = g.getEdges();
     assert(g.getEdgesCount() == edges_count);
     assert(edges.size() == savedEdges.size());
     for (auto it = edges.begin(); it != edges.end(); it++) {
@@ -103,6 +119,60 @@ void test_neighbors(IMPL impl) {
     }
 }
 
+void test_unweighted(IMPL impl) {
+    uint nodes = 60, extraNodes = 70;
+    Graph weighted(nodes, true, impl);
+    Graph unweighted(nodes, true, impl, false);
+    assert(weighted.isWeightedGraph());
+    assert(!unweighted.isWeightedGraph());
+
+    //Grow across a 64 bits word boundary
+    for (uint i = 0; i < extraNodes; ++i) {
+        weighted.addVertex();
+        unweighted.addVertex();
+    }
+    nodes += extraNodes;
+
+    for (uint i = 0; i < nodes * 8; ++i) {
+        uint from = rand()%nodes, to = rand()%nodes;
+        if(from != to && !weighted.areAdjacent(from, to)) {
+            weighted.applyEdge(from, to);
+            unweighted.applyEdge(from, to, 5);
+        }
+    }
+
+    assert(unweighted.getEdgesCount() == weighted.getEdgesCount());
+    for (uint from = 0; from < nodes; ++from) {
+        for (uint to = 0; to < nodes; ++to) {
+            if(from == to) continue;
+
+            assert(unweighted.areAdjacent(from, to) == weighted.areAdjacent(from, to));
+            if(unweighted.areAdjacent(from, to))
+                assert(unweighted.getEdgeWeight(from, to) == 1);
+            else
+                assert(unweighted.getEdgeWeight(from, to) == DEFAULT_WEIGHT && weighted.getEdgeWeight(from, to) == DEFAULT_WEIGHT);
+        }
+
+        auto it = weighted.adjacentsOf(from), uit = unweighted.adjacentsOf(from);
+        for (; it.thereIsMore(); it.advance(), uit.advance()) {
+            assert(uit.thereIsMore());
+            assert(uit.next() == it.next());
+        }
+        assert(!uit.thereIsMore());
+    }
+
+    Graph::DFSIterator dfs(0, &weighted), udfs(0, &unweighted);
+    for (; dfs.thereIsMore(); dfs.advance(), udfs.advance())
+        assert(udfs.thereIsMore() && udfs.next() == dfs.next());
+    assert(!udfs.thereIsMore());
+
+    //Non-oriented and complete
+    Graph full(nodes, false, impl, false);
+    full.fill();
+    assert(full.getEdgesCount() == nodes*(nodes-1)/2);
+    assert(full.areAdjacent(nodes-1, 0) && full.areAdjacent(0, nodes-1));
+}
+
 void test_DFS(IMPL impl) {
     uint nodes = 9, i;
     Graph g(nodes, true, impl);    
@@ -166,6 +236,1017 @@ void test_BFS(IMPL impl) {
     }
 }
 
+vector<uint> bfs_levels(const Graph& g, uint source) {
+    vector<uint> levels(g.getNodesCount(), PartitionedGraph::UNREACHED);
+    queue<uint> q;
+
+    levels[source] = 0;
+    q.push(source);
+    while(!q.empty()) {
+        uint v = q.front();
+        q.pop();
+
+        for (auto it = g.adjacentsOf(v); it.thereIsMore(); it.advance()) {
+            if(levels[it.next().first] == PartitionedGraph::UNREACHED) {
+                levels[it.next().first] = levels[v] + 1;
+                q.push(it.next().first);
+            }
+        }
+    }
+
+    return levels;
+}
+
+void test_partition(IMPL impl) {
+    uint nodes = 300, shards = 4;
+    PARTITION_STRATEGY strategies[] = {HASH_PARTITION, RANGE_PARTITION, LDG_PARTITION, FENNEL_PARTITION};
+
+    for (uint oriented = 0; oriented < 2; ++oriented) {
+        Graph g(nodes, oriented, impl);
+        for (uint i = 0; i < nodes * 2; ++i) {
+            uint from = rand()%nodes, to = rand()%nodes;
+            if(from != to && !g.areAdjacent(from, to))
+                g.applyEdge(from, to);
+        }
+
+        vector<uint> expected = bfs_levels(g, 0);
+
+        for (PARTITION_STRATEGY strategy : strategies) {
+            PartitionedGraph pg(g, shards, strategy);
+            assert(pg.getShardsCount() == shards);
+
+            //Every node is owned by exactly one shard
+            uint owned = 0;
+            for (uint i = 0; i < shards; ++i) {
+                const PartitionedGraph::Shard& shard = pg.getShard(i);
+                owned += shard.getOwnedCount();
+
+                for (uint v = 0; v < shard.getOwnedCount() + shard.getGhostsCount(); ++v) {
+                    assert(shard.toLocal(shard.toGlobal(v)) == (int) v);
+                    assert(shard.isGhost(v) == (pg.ownerOf(shard.toGlobal(v)) != i));
+                }
+            }
+            assert(owned == nodes);
+
+            assert(pg.BFS(0) == expected);
+            assert(pg.BFS(0, true) == expected);
+        }
+    }
+
+    //On a ring the greedy strategies must cut far fewer edges than hashing
+    Graph ring(nodes, false, impl);
+    for (uint v = 0; v < nodes; ++v)
+        ring.applyEdge(v, (v+1) % nodes);
+
+    uint hashCut = PartitionedGraph(ring, shards, HASH_PARTITION).getEdgeCut();
+    assert(PartitionedGraph(ring, shards, RANGE_PARTITION).getEdgeCut() == shards);
+    assert(PartitionedGraph(ring, shards, LDG_PARTITION).getEdgeCut() < hashCut);
+    assert(PartitionedGraph(ring, shards, FENNEL_PARTITION).getEdgeCut() < hashCut);
+
+    //Non-oriented self loops of owned nodes are kept once
+    Graph loops(4, false, impl);
+    loops.applyEdge(0, 0);
+    loops.applyEdge(0, 1);
+    loops.applyEdge(2, 2);
+    loops.applyEdge(2, 3);
+    PartitionedGraph whole(loops, 1, RANGE_PARTITION);
+    assert(whole.getShard(0).getGraph().getEdgesCount() == loops.getEdgesCount());
+    PartitionedGraph halves(loops, 2, RANGE_PARTITION);
+    assert(halves.getShard(0).getGraph().getEdgesCount() == 2 && halves.getShard(1).getGraph().getEdgesCount() == 2);
+}
+
+void test_compressed(IMPL impl) {
+    uint nodes = 120;
+
+    for (uint oriented = 0; oriented < 2; ++oriented) {
+        Graph g(nodes, oriented, impl);
+        for (uint i = 0; i < nodes * 10; ++i) {
+            uint from = rand()%nodes, to = rand()%nodes;
+            if(from != to && !g.areAdjacent(from, to))
+                g.applyEdge(from, to, rand()%1000 / 10.0);
+        }
+
+        CompressedGraph cg(g);
+        CompressedGraph quantized(g, true);
+        assert(cg.getNodesCount() == nodes);
+        assert(cg.getEdgesCount() == g.getEdgesCount());
+        assert(cg.isOrientedGraph() == g.isOrientedGraph());
+
+        for (uint from = 0; from < nodes; ++from) {
+            for (uint to = 0; to < nodes; ++to) {
+                if(from == to) continue;
+
+                assert(cg.areAdjacent(from, to) == g.areAdjacent(from, to));
+                if(g.areAdjacent(from, to)) {
+                    assert(cg.getEdgeWeight(from, to) == g.getEdgeWeight(from, to));
+                    assert(fabs(quantized.getEdgeWeight(from, to) - g.getEdgeWeight(from, to)) < 0.01);
+                } else {
+                    assert(cg.getEdgeWeight(from, to) == DEFAULT_WEIGHT);
+                }
+            }
+
+            //Neighbors are decoded in increasing order
+            set<pair<uint,float> > expected, decoded;
+            for (auto it = g.adjacentsOf(from); it.thereIsMore(); it.advance())
+                expected.insert(it.next());
+
+            int last = -1;
+            for (auto it = cg.adjacentsOf(from); it.thereIsMore(); it.advance()) {
+                assert((int) it.next().first > last);
+                last = it.next().first;
+                decoded.insert(it.next());
+            }
+            assert(decoded == expected);
+        }
+
+        //Traversals visit the same nodes, and in the same order when the neighbors are sorted
+        vector<uint> dfs, cdfs, bfs, cbfs;
+        for (Graph::DFSIterator it(0, &g); it.thereIsMore(); it.advance()) dfs.push_back(it.next());
+        for (CompressedGraph::DFSIterator it(0, &cg); it.thereIsMore(); it.advance()) cdfs.push_back(it.next());
+        for (Graph::BFSIterator it(0, &g); it.thereIsMore(); it.advance()) bfs.push_back(it.next());
+        for (CompressedGraph::BFSIterator it(0, &cg); it.thereIsMore(); it.advance()) cbfs.push_back(it.next());
+
+        if(impl == ADJACENCIES_MATRIX) {
+            assert(dfs == cdfs);
+            assert(bfs == cbfs);
+        } else {
+            assert(set<uint>(dfs.begin(), dfs.end()) == set<uint>(cdfs.begin(), cdfs.end()));
+            assert(set<uint>(bfs.begin(), bfs.end()) == set<uint>(cbfs.begin(), cbfs.end()));
+        }
+    }
+
+    //A complete unweighted graph takes about a byte per edge
+    Graph full(nodes, false, impl);
+    full.fill();
+    CompressedGraph cfull(full);
+    assert(cfull.getMemoryUsage() < nodes * nodes * 2);
+    assert(cfull.getEdgeWeight(0, 1) == 1);
+
+    //A non-oriented self loop is stored once
+    Graph loops(3, false, impl);
+    loops.applyEdge(0, 0);
+    loops.applyEdge(1, 2);
+    assert(CompressedGraph(loops).getEdgesCount() == loops.getEdgesCount());
+}
+
+void test_subgraph(IMPL impl) {
+    uint nodes = 200;
+    Graph g(nodes, false, impl);
+    for (uint i = 0; i < nodes * 6; ++i) {
+        uint from = rand()%nodes, to = rand()%nodes;
+        if(from != to && !g.areAdjacent(from, to))
+            g.applyEdge(from, to, rand()%100);
+    }
+
+    //Induced by the even nodes
+    vector<uint> even;
+    for (uint v = 0; v < nodes; v += 2)
+        even.push_back(v);
+
+    SubgraphView induced = SubgraphView::induced(g, even);
+    for (uint v = 0; v < nodes; ++v) {
+        assert(induced.containsNode(v) == (v % 2 == 0));
+
+        for (auto it = induced.adjacentsOf(v); it.thereIsMore(); it.advance()) {
+            assert(v % 2 == 0 && it.next().first % 2 == 0);
+            assert(g.areAdjacent(v, it.next().first));
+        }
+    }
+
+    for (SubgraphView::BFSIterator it(0, &induced); it.thereIsMore(); it.advance())
+        assert(it.next() % 2 == 0);
+
+    //The compact copy keeps every edge of the view
+    vector<uint> mapping;
+    Graph copy = induced.materialize(&mapping);
+    assert(copy.getNodesCount() == even.size());
+    assert(mapping == even);
+
+    uint viewEdges = 0;
+    for (uint i = 0; i < copy.getNodesCount(); ++i) {
+        for (uint j = 0; j < copy.getNodesCount(); ++j) {
+            if(i == j) continue;
+
+            assert(copy.areAdjacent(i, j) == induced.areAdjacent(mapping[i], mapping[j]));
+            if(copy.areAdjacent(i, j)) {
+                assert(copy.getEdgeWeight(i, j) == g.getEdgeWeight(mapping[i], mapping[j]));
+                viewEdges++;
+            }
+        }
+    }
+    assert(copy.getEdgesCount() * 2 == viewEdges);
+
+    //Parallel list edges: the view keeps the ones passing the predicate
+    Graph parallel(2, false, ADJACENCIES_LIST);
+    parallel.applyEdge(0, 1, 7);
+    parallel.applyEdge(0, 1, 3);
+    SubgraphView cheap = SubgraphView::withMaxWeight(parallel, 5);
+    assert(cheap.areAdjacent(0, 1) && cheap.areAdjacent(1, 0));
+    auto cheapAdjacents = cheap.adjacentsOf(0);
+    assert(cheapAdjacents.thereIsMore() && cheapAdjacents.next() == make_pair(1u, 3.0f));
+    assert(cheap.materialize().getEdgesCount() == 1);
+    assert(!SubgraphView::withMaxWeight(parallel, 2).areAdjacent(0, 1));
+
+    //Non-oriented self loops are kept
+    Graph loops(3, false, impl);
+    loops.applyEdge(0, 0);
+    loops.applyEdge(1, 2);
+    Graph loopsCopy = SubgraphView(loops).materialize();
+    assert(loopsCopy.getEdgesCount() == 2 && loopsCopy.areAdjacent(0, 0));
+
+    //Weight threshold
+    SubgraphView light = SubgraphView::withMaxWeight(g, 50);
+    for (uint v = 0; v < nodes; ++v)
+        for (auto it = light.adjacentsOf(v); it.thereIsMore(); it.advance())
+            assert(it.next().second <= 50);
+
+    //Painted nodes and edges
+    Graph h(5, true, impl);
+    h.applyEdge(0, 1);
+    h.applyEdge(1, 2);
+    h.applyEdge(2, 3);
+    h.applyEdge(0, 4);
+    for (auto& e : h.getEdges())
+        if(e.to != 4)
+            h.paintEdge(&e);
+    h.paintNode(0);
+    h.paintNode(1);
+    h.paintNode(2);
+    h.paintNode(4);
+
+    vector<uint> reached;
+    SubgraphView painted = SubgraphView::painted(h);
+    for (SubgraphView::DFSIterator it(0, &painted); it.thereIsMore(); it.advance())
+        reached.push_back(it.next());
+    assert(reached == vector<uint>({0, 1, 2}));
+}
+
+void test_arena(IMPL impl) {
+    uint nodes = 100;
+    Arena arena(4096);
+
+    for (uint weighted = 0; weighted < 2; ++weighted) {
+        Graph heap(nodes, true, impl, weighted);
+        Graph* g = arena.make<Graph>(nodes, true, impl, weighted, &arena);
+        assert(g->getArena() == &arena);
+        assert(arena.getAllocatedBytes() > 0);
+
+        for (uint i = 0; i < nodes * 5; ++i) {
+            uint from = rand()%nodes, to = rand()%nodes;
+            if(from != to && !heap.areAdjacent(from, to)) {
+                heap.applyEdge(from, to, i);
+                g->applyEdge(from, to, i);
+            }
+        }
+        g->addVertex();
+        heap.addVertex();
+
+        assert(g->getEdgesCount() == heap.getEdgesCount());
+        for (uint from = 0; from < nodes; ++from)
+            for (uint to = 0; to < nodes; ++to)
+                if(from != to)
+                    assert(g->getEdgeWeight(from, to) == heap.getEdgeWeight(from, to));
+
+        {
+            Graph::BFSIterator bfs(0, &heap), abfs(0, g);
+            for (; bfs.thereIsMore(); bfs.advance(), abfs.advance())
+                assert(abfs.thereIsMore() && abfs.next() == bfs.next());
+            assert(!abfs.thereIsMore());
+        }
+
+        //The graph is abandoned without destruction, the arena reclaims everything at once
+        arena.release();
+        assert(arena.getAllocatedBytes() == 0);
+    }
+}
+
+void test_copyOnWrite(IMPL impl) {
+    uint nodes = 80;
+
+    for (uint weighted = 0; weighted < 2; ++weighted) {
+        Graph base(nodes, false, impl, weighted);
+        for (uint i = 0; i < nodes * 3; ++i) {
+            uint from = rand()%nodes, to = rand()%nodes;
+            if(from != to && !base.areAdjacent(from, to))
+                base.applyEdge(from, to, i);
+        }
+        string dot = base.getDOT();
+        uint edges = base.getEdgesCount();
+
+        //Fork and edit the copy, the base graph must not change
+        Graph fork(base);
+        assert(fork.getDOT() == dot);
+
+        fork.addVertex();
+        for (uint v = 0; v < nodes; ++v)
+            if(!fork.areAdjacent(v, nodes))
+                fork.applyEdge(v, nodes, 3);
+        fork.paintNode(0);
+        for (auto& e : fork.getEdges())
+            fork.paintEdge(&e);
+
+        assert(fork.getNodesCount() == nodes + 1);
+        assert(fork.getEdgesCount() == edges + nodes);
+        assert(fork.areAdjacent(0, nodes) && fork.areAdjacent(nodes, 0));
+
+        assert(base.getNodesCount() == nodes);
+        assert(base.getEdgesCount() == edges);
+        assert(base.getDOT() == dot);
+        assert(!base.paintedNode(0));
+        for (auto& e : base.getEdges())
+            assert(!base.paintedEdge(&e));
+
+        //Pointers taken before a copy are shared, but the paint belongs to each graph
+        Graph::Edge* first = &base.getEdges().front();
+        vector<Graph::Edge*> spanning = base.minimumSpanningForest();
+        Graph painted(base);
+        base.paintEdge(first);
+        assert(base.paintedEdge(first) && !painted.paintedEdge(first));
+        painted.minimumSpanningForest(true);
+        for (Graph::Edge* e : spanning)
+            assert(painted.paintedEdge(e) && base.paintedEdge(e) == (e == first));
+        base.unpaintEdge(first);
+        assert(!base.paintedEdge(first) && base.getDOT() == dot);
+
+        //Copies of copies and assignment
+        Graph second = fork;
+        second.applyEdge(1, 2, 7);
+        Graph third;
+        third = second;
+        assert(third.getEdgesCount() == second.getEdgesCount());
+        assert(third.getDOT() == second.getDOT());
+        assert(base.getDOT() == dot);
+
+        //The read only view lists the shared and the own edges of a copy, in order
+        const Graph& constSecond = second;
+        Graph::EdgesView view = constSecond.getEdges();
+        assert(view.size() == second.getEdgesCount());
+        auto listed = second.getEdges().begin();
+        for (const auto& e : view) {
+            assert(e.from == listed->from && e.to == listed->to && e.weight == listed->weight);
+            ++listed;
+        }
+        assert(listed == second.getEdges().end());
+
+        //Copying and reading a graph only read it, so several threads can fork the same base at once
+        const Graph& constBase = base;
+        vector<uint> forkEdges(4, 0);
+        vector<thread> threads;
+        for (uint t = 0; t < 4; ++t) {
+            threads.push_back(thread([&constBase, &forkEdges, t]() {
+                Graph f(constBase);
+                f.applyEdge(t, t, t);
+                uint read = 0;
+                for (auto it = constBase.getEdges().begin(); it != constBase.getEdges().end(); ++it)
+                    read++;
+                forkEdges[t] = f.getEdgesCount() - read;
+            }));
+        }
+        for (auto& t : threads)
+            t.join();
+        assert(forkEdges == vector<uint>(4, 1));
+        assert(base.getDOT() == dot);
+
+        //Moves keep the content
+        string forkDot = fork.getDOT();
+        Graph moved(std::move(fork));
+        assert(moved.getDOT() == forkDot);
+        Graph assigned;
+        assigned = std::move(moved);
+        assert(assigned.getDOT() == forkDot);
+
+        //A moved graph is a valid empty graph, and moving never throws so containers move graphs instead of copying
+        static_assert(std::is_nothrow_move_constructible<Graph>::value, "Graph moves must not throw");
+        static_assert(std::is_nothrow_move_assignable<Graph>::value, "Graph moves must not throw");
+        assert(fork.getNodesCount() == 0 && moved.getNodesCount() == 0 && moved.getEdgesCount() == 0);
+        assert(fork.getVersion() != assigned.getVersion());
+        const Graph& movedView = moved;
+        assert(movedView.getEdges().size() == 0 && movedView.getEdges().begin() == movedView.getEdges().end());
+        assert(moved.getEdges().empty() && moved.getDOT() == Graph(0, false, impl, weighted == 1).getDOT());
+        fork.addVertex();
+        fork.addVertex();
+        fork.applyEdge(0, 1);
+        fork.paintEdge(&fork.getEdges().front());
+        assert(fork.getEdgesCount() == 1 && fork.isWeightedGraph() == (weighted == 1));
+        assert(fork.paintedEdge(&fork.getEdges().front()));
+        fork.getDOT();
+
+        //An iterator keeps seeing the row it was created on
+        Graph::AdjacentsIterator before = base.adjacentsOf(0);
+        uint degree = 0;
+        for (auto it = base.adjacentsOf(0); it.thereIsMore(); it.advance())
+            degree++;
+        for (uint v = 1; v < nodes; ++v)
+            if(!base.areAdjacent(0, v))
+                base.applyEdge(0, v);
+        for (; before.thereIsMore(); before.advance())
+            degree--;
+        assert(degree == 0);
+    }
+}
+
+uint root(vector<uint>& parent, uint v) {
+    return parent[v] == v ? v : parent[v] = root(parent, parent[v]);
+}
+
+void test_spanningForest(IMPL impl) {
+    uint nodes = 150;
+
+    for (uint oriented = 0; oriented < 2; ++oriented) {
+        Graph g(nodes, oriented, impl);
+
+        //Two separated halves, so the result is a forest of two trees
+        for (uint i = 0; i < nodes * 4; ++i) {
+            uint from = rand()%nodes, to = rand()%nodes;
+            if((from < nodes/2) != (to < nodes/2))
+                to = (to + nodes/2) % nodes;
+            if(from != to && !g.areAdjacent(from, to))
+                g.applyEdge(from, to, rand()%50);
+        }
+
+        //Reference: sequential Kruskal over a sorted copy of the edges
+        vector<Graph::Edge> sorted(g.getEdges().begin(), g.getEdges().end());
+        sort(sorted.begin(), sorted.end(), [](const Graph::Edge& a, const Graph::Edge& b) { return a.weight < b.weight; });
+        vector<uint> parent(nodes);
+        for (uint v = 0; v < nodes; ++v) parent[v] = v;
+
+        float expected = 0;
+        uint expectedEdges = 0;
+        for (const auto& e : sorted) {
+            uint a = root(parent, e.from), b = root(parent, e.to);
+            if(a != b) {
+                parent[a] = b;
+                expected += e.weight;
+                expectedEdges++;
+            }
+        }
+
+        vector<Graph::Edge*> forest = g.minimumSpanningForest(true);
+        assert(forest.size() == expectedEdges);
+
+        float total = 0;
+        for (uint v = 0; v < nodes; ++v) parent[v] = v;
+        for (Graph::Edge* e : forest) {
+            assert(g.paintedEdge(e));
+            uint a = root(parent, e->from), b = root(parent, e->to);
+            assert(a != b);
+            parent[a] = b;
+            total += e->weight;
+        }
+        assert(total == expected);
+
+        uint painted = 0;
+        for (auto& e : g.getEdges())
+            painted += g.paintedEdge(&e);
+        assert(painted == forest.size());
+    }
+
+    //A complete graph with unit weights is spanned by n-1 edges
+    Graph full(nodes, false, impl);
+    full.fill();
+    assert(full.minimumSpanningForest().size() == nodes - 1);
+
+    //Above the automatic threshold of 65536 edges, both methods choose the same forest as the reference
+    uint large = 400;
+    Graph big(large, false, impl);
+    for (uint i = 0; i < large; ++i)
+        for (uint j = i + 1; j < large; ++j)
+            big.applyEdge(i, j, rand()%1000);
+    assert(big.getEdgesCount() >= (1u << 16));
+
+    vector<Graph::Edge> sorted(big.getEdges().begin(), big.getEdges().end());
+    sort(sorted.begin(), sorted.end(), [](const Graph::Edge& a, const Graph::Edge& b) { return a.weight < b.weight; });
+    vector<uint> parent(large);
+    for (uint v = 0; v < large; ++v) parent[v] = v;
+    double expected = 0;
+    for (const auto& e : sorted) {
+        uint a = root(parent, e.from), b = root(parent, e.to);
+        if(a != b) {
+            parent[a] = b;
+            expected += e.weight;
+        }
+    }
+
+    vector<Graph::Edge*> kruskal = big.minimumSpanningForest(false, KRUSKAL_FOREST);
+    vector<Graph::Edge*> boruvka = big.minimumSpanningForest(false, BORUVKA_FOREST);
+    vector<Graph::Edge*> automatic = big.minimumSpanningForest();
+    assert(kruskal.size() == large - 1 && boruvka.size() == large - 1 && automatic.size() == large - 1);
+
+    double kruskalWeight = 0, boruvkaWeight = 0;
+    for (uint i = 0; i < large - 1; ++i) {
+        kruskalWeight += kruskal[i]->weight;
+        boruvkaWeight += boruvka[i]->weight;
+    }
+    assert(kruskalWeight == expected && boruvkaWeight == expected);
+
+    sort(kruskal.begin(), kruskal.end());
+    sort(boruvka.begin(), boruvka.end());
+    sort(automatic.begin(), automatic.end());
+    assert(kruskal == boruvka && kruskal == automatic);
+}
+
+void test_topologicalOrder(IMPL impl) {
+    uint nodes = 120;
+    Graph g(nodes, true, impl);
+    g.maintainTopologicalOrder();
+    assert(g.maintainsTopologicalOrder());
+
+    for (uint i = 0; i < nodes * 6; ++i) {
+        uint from = rand()%nodes, to = rand()%nodes;
+
+        bool closes = from == to || bfs_levels(g, to)[from] != PartitionedGraph::UNREACHED;
+        assert(g.wouldCloseCycle(from, to) == closes);
+
+        uint edges = g.getEdgesCount();
+        try {
+            g.applyEdge(from, to);
+            assert(!closes);
+        } catch (invalid_argument& e) {
+            assert(closes);
+            assert(g.getEdgesCount() == edges);
+        }
+    }
+
+    //The order is a permutation and every edge goes forward in it
+    for (uint i = 0; i < nodes; ++i)
+        assert(g.topologicalIndex(g.topologicalNode(i)) == i);
+    for (const auto& e : g.getEdges())
+        assert(g.topologicalIndex(e.from) < g.topologicalIndex(e.to));
+
+    //New nodes go last, copies keep their own order
+    uint v = g.addVertex() - 1;
+    assert(g.topologicalIndex(v) == nodes);
+
+    Graph copy(g);
+    uint first = g.topologicalNode(0);
+    copy.applyEdge(v, first);
+    assert(copy.topologicalIndex(v) < copy.topologicalIndex(first));
+    assert(g.topologicalIndex(v) == nodes);
+    assert(g.wouldCloseCycle(first, v) == false);
+
+    //Enabling on the same edges gives a valid order too
+    Graph fresh(nodes, true, impl);
+    for (const auto& e : g.getEdges())
+        fresh.applyEdge(e.from, e.to);
+    fresh.maintainTopologicalOrder();
+    for (const auto& e : fresh.getEdges())
+        assert(fresh.topologicalIndex(e.from) < fresh.topologicalIndex(e.to));
+
+    g.maintainTopologicalOrder(false);
+    assert(!g.maintainsTopologicalOrder());
+
+    Graph cyclic(3, true, impl);
+    cyclic.applyEdge(0, 1);
+    cyclic.applyEdge(1, 2);
+    cyclic.applyEdge(2, 0);
+    bool thrown = false;
+    try { cyclic.maintainTopologicalOrder(); } catch (invalid_argument& e) { thrown = true; }
+    assert(thrown);
+
+    Graph nonOriented(3, false, impl);
+    thrown = false;
+    try { nonOriented.maintainTopologicalOrder(); } catch (invalid_argument& e) { thrown = true; }
+    assert(thrown);
+}
+
+void test_shortestPaths(IMPL impl) {
+    uint nodes = 150;
+
+    for (uint oriented = 0; oriented < 2; ++oriented) {
+        Graph g(nodes, oriented, impl);
+        for (uint i = 0; i < nodes * 3; ++i) {
+            uint from = rand()%nodes, to = rand()%nodes;
+            if(from != to && !g.areAdjacent(from, to))
+                g.applyEdge(from, to, 1 + rand()%20);
+        }
+        uint isolated = g.addVertex() - 1;
+
+        //Reference: the naive triple loop over a copy of the weights
+        uint n = g.getNodesCount();
+        vector<vector<float> > expected(n, vector<float>(n, DEFAULT_WEIGHT));
+        for (uint v = 0; v < n; ++v) {
+            expected[v][v] = 0;
+            for (auto it = g.adjacentsOf(v); it.thereIsMore(); it.advance())
+                expected[v][it.next().first] = it.next().second;
+        }
+        for (uint k = 0; k < n; ++k)
+            for (uint i = 0; i < n; ++i)
+                for (uint j = 0; j < n; ++j)
+                    if(expected[i][k] != DEFAULT_WEIGHT && expected[k][j] != DEFAULT_WEIGHT)
+                        expected[i][j] = min(expected[i][j], expected[i][k] + expected[k][j]);
+
+        AllPairsShortestPaths apsp(g, true);
+        assert(apsp.getNodesCount() == n);
+        assert(!apsp.hasNegativeCycle());
+
+        for (uint i = 0; i < n; ++i) {
+            for (uint j = 0; j < n; ++j) {
+                assert(apsp.getDistance(i, j) == expected[i][j]);
+
+                vector<uint> path = apsp.getPath(i, j);
+                if(expected[i][j] == DEFAULT_WEIGHT) {
+                    assert(path.empty());
+                    continue;
+                }
+
+                assert(path.front() == i && path.back() == j);
+                float length = 0;
+                for (uint p = 1; p < path.size(); ++p)
+                    length += g.getEdgeWeight(path[p-1], path[p]);
+                assert(length == expected[i][j]);
+            }
+        }
+
+        assert(apsp.getDistance(0, isolated) == DEFAULT_WEIGHT);
+    }
+
+    //Negative weights are allowed, a negative cycle is reported
+    Graph negative(3, true, impl);
+    negative.applyEdge(0, 1, 4);
+    negative.applyEdge(1, 2, -3);
+    AllPairsShortestPaths noCycle(negative);
+    assert(noCycle.getDistance(0, 2) == 1);
+    assert(!noCycle.hasNegativeCycle());
+
+    negative.applyEdge(2, 0, -2);
+    assert(AllPairsShortestPaths(negative).hasNegativeCycle());
+
+    bool thrown = false;
+    try { noCycle.getPath(0, 2); } catch (invalid_argument& e) { thrown = true; }
+    assert(thrown);
+}
+
+vector<set<pair<uint,float> > > adjacencies(const Graph& g) {
+    vector<set<pair<uint,float> > > result(g.getNodesCount());
+    for (uint v = 0; v < g.getNodesCount(); ++v)
+        for (auto it = g.adjacentsOf(v); it.thereIsMore(); it.advance())
+            result[v].insert(it.next());
+    return result;
+}
+
+void test_convert(IMPL impl) {
+    IMPL other = impl == ADJACENCIES_MATRIX ? ADJACENCIES_LIST : ADJACENCIES_MATRIX;
+    uint nodes = 200;
+
+    for (uint mode = 0; mode < 4; ++mode) {
+        bool oriented = mode & 1, weighted = mode & 2;
+        Graph g(nodes, oriented, impl, weighted);
+        for (uint i = 0; i < nodes * 3; ++i) {
+            uint from = rand()%nodes, to = rand()%nodes;
+            if(from != to && !g.areAdjacent(from, to))
+                g.applyEdge(from, to, 1 + rand()%20);
+        }
+        g.addVertex();
+        g.paintNode(3);
+
+        auto expected = adjacencies(g);
+        uint edges = g.getEdgesCount();
+        auto before = g.adjacentsOf(0);
+
+        Graph::ConversionReport report = g.convertTo(other);
+        assert(g.getImplementation() == other);
+        assert(report.from == impl && report.to == other);
+        assert(report.bytesBefore == g.getConversionReports()[0].bytesBefore);
+        assert(report.bytesAfter == g.getMemoryUsage());
+        assert(adjacencies(g) == expected);
+        assert(g.getEdgesCount() == edges);
+        assert(g.paintedNode(3));
+
+        //Iterators from before the conversion still walk the old adjacencies
+        set<pair<uint,float> > walked;
+        for (; before.thereIsMore(); before.advance())
+            walked.insert(before.next());
+        assert(walked == expected[0]);
+
+        g.applyEdge(0, nodes, 7);
+        g.convertTo(impl);
+        assert(g.getImplementation() == impl);
+        assert(g.areAdjacent(0, nodes));
+        assert(g.getConversionReports().size() == 2);
+    }
+
+    //Adaptive mode follows the density, with a gap between both thresholds
+    Graph g(40, false, ADJACENCIES_LIST);
+    g.setAdaptive(true, 0.5, 0.1);
+    assert(g.isAdaptive());
+
+    for (uint i = 0; i < 40 && g.getImplementation() == ADJACENCIES_LIST; ++i)
+        for (uint j = i + 1; j < 40; ++j)
+            g.applyEdge(i, j);
+
+    assert(g.getImplementation() == ADJACENCIES_MATRIX);
+    assert(g.getConversionReports().size() == 1);
+    assert(g.getConversionReports()[0].density >= 0.5);
+
+    while(g.getImplementation() == ADJACENCIES_MATRIX)
+        g.addVertex();
+    assert(g.getDensity() <= 0.1);
+    assert(g.getConversionReports().size() == 2);
+    assert(g.getConversionReports()[1].bytesAfter < g.getConversionReports()[1].bytesBefore);
+
+    bool thrown = false;
+    try { g.setAdaptive(true, 0.1, 0.5); } catch (invalid_argument& e) { thrown = true; }
+    assert(thrown);
+}
+
+void test_queryCache(IMPL impl) {
+    uint nodes = 120;
+    Graph g(nodes, true, impl);
+    for (uint i = 0; i < nodes * 2; ++i) {
+        uint from = rand()%nodes, to = rand()%nodes;
+        if(from != to && !g.areAdjacent(from, to))
+            g.applyEdge(from, to, 1 + rand()%20);
+    }
+
+    QueryCache cache(g);
+    uint64_t version = g.getVersion();
+
+    vector<uint> expected;
+    for (Graph::BFSIterator it(0, &g); it.thereIsMore(); it.advance())
+        expected.push_back(it.next());
+
+    assert(cache.BFS(0) == expected);
+    assert(cache.getMisses() == 1 && cache.getHits() == 0);
+    assert(cache.BFS(0) == expected);
+    for (uint v = 0; v < nodes; ++v)
+        assert(cache.isReachable(0, v) == (find(expected.begin(), expected.end(), v) != expected.end()));
+    assert(cache.getMisses() == 1 && cache.getHits() == 1 + nodes);
+
+    AllPairsShortestPaths apsp(g);
+    for (uint s = 0; s < 10; ++s) {
+        for (uint t = 0; t < nodes; ++t) {
+            assert(cache.getDistance(s, t) == apsp.getDistance(s, t));
+
+            vector<uint> path = cache.getPath(s, t);
+            assert(path.empty() == (apsp.getDistance(s, t) == DEFAULT_WEIGHT));
+            float length = 0;
+            for (uint p = 1; p < path.size(); ++p)
+                length += g.getEdgeWeight(path[p-1], path[p]);
+            assert(path.empty() || length == apsp.getDistance(s, t));
+        }
+    }
+    assert(cache.getMisses() == 11);
+    assert(cache.getHitRate() > 0.9);
+
+    //Copies keep the version, a modification gives a new one and the results are computed again
+    Graph copy(g);
+    assert(copy.getVersion() == version);
+
+    uint isolated = g.addVertex() - 1;
+    g.applyEdge(0, isolated);
+    assert(g.getVersion() != version && copy.getVersion() == version);
+
+    uint64_t misses = cache.getMisses();
+    assert(cache.isReachable(0, isolated));
+    assert(cache.getMisses() == misses + 1);
+
+    //A conversion changes the order of the neighbors and the weight of repeated list edges
+    Graph list(4, true, ADJACENCIES_LIST);
+    list.applyEdge(0, 3);
+    list.applyEdge(0, 1, 1);
+    list.applyEdge(0, 2);
+    list.applyEdge(0, 1, 5);
+    QueryCache listCache(list);
+    assert(listCache.BFS(0) == vector<uint>({0, 3, 1, 2}));
+    assert(listCache.getDistance(0, 1) == 1);
+
+    version = list.getVersion();
+    list.convertTo(ADJACENCIES_MATRIX);
+    assert(list.getVersion() != version);
+    assert(listCache.BFS(0) == vector<uint>({0, 1, 2, 3}));
+    assert(listCache.getDistance(0, 1) == 5);
+
+    //The memory bound evicts the least recently used results
+    QueryCache small(g, 4096);
+    for (uint s = 0; s < nodes; ++s)
+        small.BFS(s);
+    assert(small.getMemoryUsage() <= 4096);
+    assert(small.getEntriesCount() < nodes);
+
+    misses = small.getMisses();
+    small.BFS(nodes - 1);
+    assert(small.getMisses() == misses);
+    small.BFS(0);
+    assert(small.getMisses() == misses + 1);
+
+    small.clear();
+    assert(small.getEntriesCount() == 0 && small.getMemoryUsage() == 0);
+}
+
+void test_landmarks(IMPL impl) {
+    uint nodes = 300;
+
+    for (uint oriented = 0; oriented < 2; ++oriented) {
+        Graph g(nodes, oriented, impl);
+
+        //Two separated halves and an isolated node
+        for (uint i = 0; i < nodes * 3; ++i) {
+            uint from = rand()%(nodes - 1), to = rand()%(nodes - 1);
+            if((from < nodes/2) != (to < nodes/2))
+                to = (to + nodes/2) % (nodes - 1);
+            if(from != to && !g.areAdjacent(from, to))
+                g.applyEdge(from, to, 1 + rand()%20);
+        }
+
+        LandmarkIndex index(g, 6);
+        assert(index.getLandmarks().size() == 6);
+        assert(set<uint>(index.getLandmarks().begin(), index.getLandmarks().end()).size() == 6);
+
+        index.save("landmarks_test.alt");
+        LandmarkIndex loaded = LandmarkIndex::load(g, "landmarks_test.alt");
+        remove("landmarks_test.alt");
+        assert(loaded.getLandmarks() == index.getLandmarks());
+
+        for (uint s = 0; s < nodes; s += 7) {
+            SingleSourceShortestPaths dijkstra(g, s);
+
+            for (uint t = 0; t < nodes; ++t) {
+                assert(index.getDistance(s, t) == dijkstra.getDistance(t));
+                assert(loaded.getDistance(s, t) == dijkstra.getDistance(t));
+
+                vector<uint> path = index.getPath(s, t);
+                assert(path.empty() == (dijkstra.getDistance(t) == DEFAULT_WEIGHT));
+                if(path.empty()) continue;
+
+                assert(path.front() == s && path.back() == t);
+                float length = 0;
+                for (uint p = 1; p < path.size(); ++p)
+                    length += g.getEdgeWeight(path[p-1], path[p]);
+                assert(length == dijkstra.getDistance(t));
+            }
+        }
+
+        //The index is bound to the version of the graph
+        g.applyEdge(0, nodes - 1);
+        bool thrown = false;
+        try { index.getDistance(0, 1); } catch (invalid_argument& e) { thrown = true; }
+        assert(thrown);
+
+        thrown = false;
+        try { LandmarkIndex::load(Graph(nodes + 1, oriented, impl), "missing_file.alt"); } catch (runtime_error& e) { thrown = true; }
+        assert(thrown);
+    }
+}
+
+// Nodes reachable from each node, by a DFS on the graph
+vector<vector<bool> > reachable_by_DFS(const Graph& g) {
+    vector<vector<bool> > reached(g.getNodesCount(), vector<bool>(g.getNodesCount(), false));
+    for (uint v = 0; v < g.getNodesCount(); ++v)
+        for (Graph::DFSIterator it(v, &g); it.thereIsMore(); it.advance())
+            reached[v][it.next()] = true;
+    return reached;
+}
+
+void test_reachability(IMPL impl) {
+    uint nodes = 200;
+
+    for (uint oriented = 0; oriented < 2; ++oriented) {
+        Graph g(nodes, oriented, impl);
+
+        //Mostly forward edges, with a few backward ones closing cycles
+        for (uint i = 0; i < nodes; ++i) {
+            uint from = rand()%nodes, to = rand()%nodes;
+            if(from > to && rand()%8 != 0)
+                swap(from, to);
+            g.applyEdge(from, to);
+        }
+
+        ReachabilityIndex index(g, 2, 16);
+        assert(index.getPendingEdgesCount() == 0);
+
+        vector<vector<bool> > expected = reachable_by_DFS(g);
+        for (uint v = 0; v < nodes; ++v) {
+            for (uint w = 0; w < nodes; ++w) {
+                assert(index.isReachable(v, w) == expected[v][w]);
+                if(expected[v][w])
+                    assert(index.getComponent(v) >= index.getComponent(w));
+                assert((index.getComponent(v) == index.getComponent(w)) == (expected[v][w] && expected[w][v]));
+            }
+        }
+        assert(oriented || index.getFallbacksCount() == 0);
+
+        //Edges applied through the index are kept pending until there are too many. Half of them reach
+        //isolated nodes, so they are new reachabilities for sure
+        for (uint i = 0; i < 20; ++i)
+            g.addVertex();
+
+        bool rebuilt = false;
+        for (uint i = 0; i < 40; ++i) {
+            uint pending = index.getPendingEdgesCount();
+            index.applyEdge(rand()%nodes, i % 2 ? nodes + i / 2 : rand()%nodes);
+            rebuilt = rebuilt || index.getPendingEdgesCount() < pending;
+            assert(index.getPendingEdgesCount() <= 16);
+
+            if(i % 8 != 0) continue;
+            expected = reachable_by_DFS(g);
+            for (uint v = 0; v < g.getNodesCount(); ++v)
+                for (uint w = 0; w < g.getNodesCount(); ++w)
+                    assert(index.isReachable(v, w) == expected[v][w]);
+        }
+        assert(rebuilt);
+
+        //Any other modification of the graph builds the index again
+        uint last = g.addVertex() - 1;
+        g.applyEdge(last, 0);
+        assert(index.isReachable(last, 0) && index.getPendingEdgesCount() == 0);
+        assert(index.isReachable(0, last) == !oriented);
+
+        bool thrown = false;
+        try { index.isReachable(0, last + 1); } catch (invalid_argument& e) { thrown = true; }
+        assert(thrown);
+
+        thrown = false;
+        try { ReachabilityIndex(g, 0); } catch (invalid_argument& e) { thrown = true; }
+        assert(thrown);
+    }
+}
+
+template<uint N>
+void compare_static(const Graph& g, IMPL impl) {
+    StaticGraph<N> sg(g.getNodesCount(), g.isOrientedGraph());
+    for (const auto& e : g.getEdges())
+        sg.applyEdge(e.from, e.to);
+
+    assert(sg.getEdgesCount() == g.getEdgesCount());
+
+    for (uint v = 0; v < g.getNodesCount(); ++v) {
+        assert(sg.isIsolatedNode(v) == g.isIsolatedNode(v));
+        for (uint w = 0; w < g.getNodesCount(); ++w) {
+            assert(sg.areAdjacent(v, w) == g.areAdjacent(v, w));
+            assert(sg.getEdgeWeight(v, w) == g.getEdgeWeight(v, w));
+        }
+
+        uint degree = 0;
+        for (auto it = sg.adjacentsOf(v); it.thereIsMore(); it.advance()) {
+            assert(g.areAdjacent(v, it.next().first) && it.next().second == 1);
+            degree++;
+        }
+        assert(sg.getDegree(v) == degree);
+    }
+
+    //Same traversals as a Graph over a matrix, the same nodes on lists
+    for (uint source = 0; source < g.getNodesCount(); source += 5) {
+        vector<uint> dfs, bfs, staticDfs, staticBfs;
+        for (Graph::DFSIterator it(source, &g); it.thereIsMore(); it.advance()) dfs.push_back(it.next());
+        for (Graph::BFSIterator it(source, &g); it.thereIsMore(); it.advance()) bfs.push_back(it.next());
+
+        for (typename StaticGraph<N>::DFSIterator it(source, &sg); it.thereIsMore(); it.advance()) staticDfs.push_back(it.next());
+        for (typename StaticGraph<N>::BFSIterator it(source, &sg); it.thereIsMore(); it.advance()) staticBfs.push_back(it.next());
+
+        if(impl == ADJACENCIES_LIST) {
+            sort(dfs.begin(), dfs.end()); sort(staticDfs.begin(), staticDfs.end());
+            sort(bfs.begin(), bfs.end()); sort(staticBfs.begin(), staticBfs.end());
+        }
+        assert(staticDfs == dfs);
+        assert(staticBfs == bfs);
+    }
+}
+
+void test_staticGraph(IMPL impl) {
+    for (uint oriented = 0; oriented < 2; ++oriented) {
+        Graph small(40, oriented, impl, false);
+        Graph big(150, oriented, impl, false);
+        for (uint i = 0; i < 60; ++i) {
+            uint from = rand()%40, to = rand()%40;
+            if(from != to && !small.areAdjacent(from, to))
+                small.applyEdge(from, to);
+        }
+        for (uint i = 0; i < 400; ++i) {
+            uint from = rand()%150, to = rand()%150;
+            if(from != to && !big.areAdjacent(from, to))
+                big.applyEdge(from, to);
+        }
+
+        compare_static<64>(small, impl);
+        compare_static<150>(big, impl);
+    }
+
+    //The example of test_DFS, over a graph sized at compile time
+    StaticGraph<9> g(9, true);
+    uint edges[10][2] = {{0,1}, {0,2}, {2,3}, {2,4}, {3,5}, {3,6}, {3,7}, {4,7}, {4,8}, {6,8}};
+    for (uint i = 0; i < 10; ++i)
+        g.applyEdge(edges[i][0], edges[i][1]);
+
+    uint i = 0;
+    uint expected_dfs[9] = {0, 2, 4, 8, 7, 3, 6, 5, 1};
+    for (StaticGraph<9>::DFSIterator dfs(0, &g); dfs.thereIsMore(); dfs.advance())
+        assert(dfs.next() == expected_dfs[i++]);
+    assert(i == 9);
+
+    g.fill();
+    assert(g.getEdgesCount() == 9 * 8);
+
+    StaticGraph<4> growing(2);
+    assert(growing.addVertex() == 3 && growing.addVertex() == 4);
+    bool thrown = false;
+    try { growing.addVertex(); } catch (invalid_argument& e) { thrown = true; }
+    assert(thrown);
+
+    constexpr StaticGraph<64> empty(10);
+    static_assert(!empty.areAdjacent(1, 2) && empty.getDegree(3) == 0 && StaticGraph<64>::capacity() == 64
+                  && empty.getEdgeWeight(1, 2) == std::numeric_limits<float>::max(), "constexpr queries");
+}
+
 int main() {
     test_addAndGetNodes(ADJACENCIES_MATRIX);
     test_addAndGetNodes(ADJACENCIES_LIST);
@@ -183,6 +1264,10 @@ int main() {
     test_neighbors(ADJACENCIES_LIST);
     printf("Test neighbors passed!\n");
 
+    test_unweighted(ADJACENCIES_MATRIX);
+    test_unweighted(ADJACENCIES_LIST);
+    printf("Test unweighted passed!\n");
+
     test_DFS(ADJACENCIES_MATRIX);
     test_DFS(ADJACENCIES_LIST);
     printf("Test DFS passed!\n");
@@ -191,6 +1276,58 @@ int main() {
     test_BFS(ADJACENCIES_LIST);
     printf("Test BFS passed!\n");
 
+    test_partition(ADJACENCIES_MATRIX);
+    test_partition(ADJACENCIES_LIST);
+    printf("Test partition passed!\n");
+
+    test_compressed(ADJACENCIES_MATRIX);
+    test_compressed(ADJACENCIES_LIST);
+    printf("Test compressed passed!\n");
+
+    test_subgraph(ADJACENCIES_MATRIX);
+    test_subgraph(ADJACENCIES_LIST);
+    printf("Test subgraph passed!\n");
+
+    test_arena(ADJACENCIES_MATRIX);
+    test_arena(ADJACENCIES_LIST);
+    printf("Test arena passed!\n");
+
+    test_copyOnWrite(ADJACENCIES_MATRIX);
+    test_copyOnWrite(ADJACENCIES_LIST);
+    printf("Test copyOnWrite passed!\n");
+
+    test_spanningForest(ADJACENCIES_MATRIX);
+    test_spanningForest(ADJACENCIES_LIST);
+    printf("Test spanningForest passed!\n");
+
+    test_topologicalOrder(ADJACENCIES_MATRIX);
+    test_topologicalOrder(ADJACENCIES_LIST);
+    printf("Test topologicalOrder passed!\n");
+
+    test_shortestPaths(ADJACENCIES_MATRIX);
+    test_shortestPaths(ADJACENCIES_LIST);
+    printf("Test shortestPaths passed!\n");
+
+    test_convert(ADJACENCIES_MATRIX);
+    test_convert(ADJACENCIES_LIST);
+    printf("Test convert passed!\n");
+
+    test_queryCache(ADJACENCIES_MATRIX);
+    test_queryCache(ADJACENCIES_LIST);
+    printf("Test queryCache passed!\n");
+
+    test_landmarks(ADJACENCIES_MATRIX);
+    test_landmarks(ADJACENCIES_LIST);
+    printf("Test landmarks passed!\n");
+
+    test_staticGraph(ADJACENCIES_MATRIX);
+    test_staticGraph(ADJACENCIES_LIST);
+    printf("Test staticGraph passed!\n");
+
+    test_reachability(ADJACENCIES_MATRIX);
+    test_reachability(ADJACENCIES_LIST);
+    printf("Test reachability passed!\n");
+
     printf("\nAll test passed!!!!!!!\n\n");
 
     return 0;
@@ -0,0 +1,116 @@
+#ifndef __TRAVERSAL__H__
+#define __TRAVERSAL__H__
+
+#include <vector>
+#include <stack>
+#include <queue>
+#include <deque>
+#include <stdexcept>
+#include "arena.h"
+
+typedef unsigned int uint;
+
+/*
+ * Depth first traversal of the nodes reachable from a source node, over any graph type G providing
+ * getNodesCount() and adjacentsOf(v), an iterator over pairs (node, weight) with next(), advance() and thereIsMore().
+ * Each graph type names its own traversal after it, as G::DFSIterator. The stack and the visited marks allocate
+ * from the given arena, if any.
+ */
+template<class G>
+class DFSTraversal {
+
+    public:
+        DFSTraversal(uint source, const G* g, Arena* arena = NULL)
+            : _g(g), _source(source), _q(std::deque<uint, ArenaAllocator<uint> >(arena)), _visited_nodes(arena) {
+            if(source >= g->getNodesCount())
+                throw std::invalid_argument("Invalid argument on DFSIterator constructor, source is not a node of the graph.");
+
+            _visited_nodes.assign(g->getNodesCount(), false);
+            _q.push(source);
+        }
+
+        /*
+         * Get current node of the iterator. This not modify the iterator status.
+         */
+        uint next() const {
+            return _q.top();
+        }
+
+        void advance() {
+            do {
+                uint last = _q.top();
+                _q.pop();
+
+                if(!_visited_nodes[last]) {
+                    _visited_nodes[last] = true;
+
+                    for(auto it = _g->adjacentsOf(last); it.thereIsMore(); it.advance())
+                        if(!_visited_nodes[it.next().first])
+                            _q.push(it.next().first);
+                }
+
+            } while(!_q.empty() && _visited_nodes[_q.top()]);
+        }
+
+        bool thereIsMore() const {
+            return !_q.empty();
+        }
+
+    private:
+        const G* _g;
+        uint _source;
+        std::stack<uint, std::deque<uint, ArenaAllocator<uint> > > _q;
+        std::vector<bool, ArenaAllocator<bool> > _visited_nodes;
+};
+
+/*
+ * Breadth first traversal of the nodes reachable from a source node, over any graph type G, idem to DFSTraversal.
+ */
+template<class G>
+class BFSTraversal {
+
+    public:
+        BFSTraversal(uint source, const G* g, Arena* arena = NULL)
+            : _g(g), _source(source), _q(std::deque<uint, ArenaAllocator<uint> >(arena)), _visited_nodes(arena) {
+            if(source >= g->getNodesCount())
+                throw std::invalid_argument("Invalid argument on BFSIterator constructor, source is not a node of the graph.");
+
+            _visited_nodes.assign(g->getNodesCount(), false);
+            _q.push(source);
+        }
+
+        /*
+         * Get current node of the iterator. This not modify the iterator status.
+         */
+        uint next() const {
+            return _q.front();
+        }
+
+        void advance() {
+            do {
+                uint last = _q.front();
+                _q.pop();
+
+                if(!_visited_nodes[last]) {
+                    _visited_nodes[last] = true;
+
+                    for(auto it = _g->adjacentsOf(last); it.thereIsMore(); it.advance())
+                        if(!_visited_nodes[it.next().first])
+                            _q.push(it.next().first);
+                }
+
+            } while(!_q.empty() && _visited_nodes[_q.front()]);
+        }
+
+        bool thereIsMore() const {
+            return !_q.empty();
+        }
+
+    private:
+        const G* _g;
+        uint _source;
+        std::queue<uint, std::deque<uint, ArenaAllocator<uint> > > _q;
+        std::vector<bool, ArenaAllocator<bool> > _visited_nodes;
+};
+
+#endif